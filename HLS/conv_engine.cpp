@@ -3,7 +3,8 @@
  *
  * ARCHITECTURE OVERVIEW
  * =====================
- * Three-stage DATAFLOW pipeline: Fetch → Execute → Write
+ * Four-process DATAFLOW pipeline: Fetch (input ∥ weights) → Execute → Write
+ * plus a fused conv1→conv3 row-streaming pipeline (fuse_early=1)
  *
  * "Verilog-like" means:
  *  - Every DRAM access goes through an explicit DMA staging buffer
@@ -33,6 +34,9 @@
  *  (vs 0.3 FPS in V1 — 160-200× improvement)
  */
 #include "conv_engine_v3.h"
+#ifndef __SYNTHESIS__
+#include <cassert>
+#endif
 
 /* =========================================================================
  * HELPER: Activation (inlined — becomes combinational logic)
@@ -50,6 +54,93 @@ static data_t activate(data_t x, int use_leaky) {
     return (data_t)0;                         // ReLU: clamp to zero
 }
 
+/* =========================================================================
+ * HELPERS: MAC datapath (see MAC_CASCADE in the header)
+ * mac_prod: one lane's product.  In the cascade it is the exact raw
+ * 16×16 product (A·B of a DSP48E2); data_t has 8 fraction bits, so the
+ * raw product has acc_t's 16.
+ * mac_to_acc / acc_to_mac: the only clamp on the cascade path, and its
+ * inverse for psum reloads.  Identities for the adder tree.
+ * Verilog analogy: P = PCIN + A*B;  sat = (P > MAX) ? MAX : ...
+ * ========================================================================= */
+static inline mac_t mac_prod(data_t w, data_t x) {
+    #pragma HLS INLINE
+#if MAC_CASCADE
+    int a = (ap_int<16>)w.range(15, 0);
+    int b = (ap_int<16>)x.range(15, 0);
+    return (mac_t)(a * b);
+#else
+    return (acc_t)(w * x);
+#endif
+}
+
+static inline acc_t mac_to_acc(mac_t m) {
+    #pragma HLS INLINE
+#if MAC_CASCADE
+    const mac_t hi =  0x7FFFFFFFLL;
+    const mac_t lo = -0x80000000LL;
+    ap_int<32> r = (m > hi) ? hi : (m < lo) ? lo : m;
+    acc_t a;
+    a.range(31, 0) = r.range(31, 0);
+    return a;
+#else
+    return m;
+#endif
+}
+
+static inline mac_t acc_to_mac(acc_t a) {
+    #pragma HLS INLINE
+#if MAC_CASCADE
+    ap_int<32> r = (ap_int<32>)a.range(31, 0);
+    return (mac_t)r;
+#else
+    return a;
+#endif
+}
+
+/* =========================================================================
+ * HELPER: Folded-BN epilogue — per-OC scale (W8A16 dequant), bias,
+ * activation.  The scale word is { m[10:0], e[4:0] } = (1 + m/2048)·2^e
+ * (weight layout in the header): the 2^e is a barrel shift; the mantissa
+ * is a 32×11 multiply per OC lane, built only with WT8_SCALE_MANT.
+ * 16-bit layers carry scale 1 (word 0).  The cascade shifts the wide sum
+ * first, so the clamp sees the scaled value.
+ * Verilog analogy: barrel shifter → (multiplier) → adder → activation MUX
+ * ========================================================================= */
+static data_t epilogue(mac_t a, ap_int<16> scl, data_t bias, int use_leaky) {
+    #pragma HLS INLINE
+    int sh = (ap_int<5>)scl.range(4, 0);
+#if MAC_CASCADE
+    acc_t scaled = mac_to_acc((sh >= 0) ? (mac_t)(a << sh) : (mac_t)(a >> -sh));
+#else
+    acc_t scaled = (sh >= 0) ? (acc_t)(a << sh) : (acc_t)(a >> -sh);
+#endif
+#if WT8_SCALE_MANT
+    ap_ufixed<11, 0> m;
+    m.range(10, 0) = scl.range(15, 5);
+    scaled = (acc_t)(scaled + scaled * m);
+#endif
+    return activate((data_t)(scaled + bias), use_leaky);
+}
+
+/* =========================================================================
+ * HELPER: One weight beat → a bank of the weight register file
+ * Dense: beat (oc, ky, kx) is the 16 IC lanes of that OC row.
+ * Depthwise: beat (ky, kx) is one tap of all 16 channels; channel c's tap
+ * lands in OC row c at IC lane ky·K_MAX + kx, where the sideways MAC array
+ * reads it (see Execute_Layer).
+ * Verilog analogy: write-enable decode into a register file
+ * ========================================================================= */
+static inline void load_wt_beat(data_t wt_buf[2][TILE_OC][TILE_IC][K_MAX][K_MAX],
+                                int bank, vec_t beat, int oc, int ky, int kx, bool dw) {
+    #pragma HLS INLINE
+    LOAD_WT_LANE: for (int l = 0; l < TILE_IC; l++) {
+        #pragma HLS UNROLL
+        if (dw) wt_buf[bank][l][ky * K_MAX + kx][0][0].range(15, 0) = beat.range(l*16+15, l*16);
+        else    wt_buf[bank][oc][l][ky][kx].range(15, 0)             = beat.range(l*16+15, l*16);
+    }
+}
+
 /* =========================================================================
  * HELPER: Extract 16-bit element from 256-bit word
  * Verilog analogy: wire [15:0] elem = word[slot*16 +: 16];
@@ -61,6 +152,22 @@ static inline data_t extract_elem(wide_t word, int slot) {
     return val;
 }
 
+/* =========================================================================
+ * HELPER: Extract int8 weight from 256-bit word (W8A16 mode)
+ * The byte q is read as q/128 in data_t (exact: 7 of 8 fraction bits);
+ * the per-OC dequant scale comes from the block's scale header word and
+ * is applied in the epilogue.
+ * Verilog analogy: wire [15:0] w = {{7{q[7]}}, q, 1'b0};
+ * ========================================================================= */
+static inline data_t extract_wt8(wide_t word, int slot) {
+    #pragma HLS INLINE
+    ap_int<8>  q = word.range(slot * 8 + 7, slot * 8);
+    ap_int<16> raw = ((ap_int<16>)q) << 1;
+    data_t val;
+    val.range(15, 0) = raw.range(15, 0);
+    return val;
+}
+
 /* =========================================================================
  * HELPER: Insert 16-bit element into 256-bit word
  * Verilog analogy: word[slot*16 +: 16] <= elem;
@@ -71,50 +178,213 @@ static inline void insert_elem(wide_t& word, int slot, data_t val) {
 }
 
 /* =========================================================================
- * STAGE 1: FETCH LAYER — IC-OUTER / OC-INNER
+ * HELPER: Activation in either DRAM format (see ACT8 in the header)
+ * act_shift < 0: 16-bit data_t, slot 0..15
+ * act_shift ≥ 0: int8 byte, slot 0..31, raw bits = q << act_shift
+ * Verilog analogy: wire [15:0] a = act8 ? $signed(word[slot*8 +: 8]) <<< sh
+ *                                       : word[slot*16 +: 16];
+ * ========================================================================= */
+static inline data_t extract_act(wide_t word, int slot, int act_shift) {
+    #pragma HLS INLINE
+    if (act_shift < 0) return extract_elem(word, slot);
+    ap_int<8>  q   = word.range(slot * 8 + 7, slot * 8);
+    ap_int<16> raw = ((ap_int<16>)q) << act_shift;
+    data_t val;
+    val.range(15, 0) = raw.range(15, 0);
+    return val;
+}
+
+/* Round-half-up, then saturate to int8 (same rounding as data_t's AP_RND) */
+static inline void insert_act(wide_t& word, int slot, data_t val, int act_shift) {
+    #pragma HLS INLINE
+    if (act_shift < 0) { insert_elem(word, slot, val); return; }
+    int raw = (ap_int<16>)val.range(15, 0);
+    if (act_shift > 0) raw += 1 << (act_shift - 1);
+    raw >>= act_shift;
+    ap_int<8> q = (raw > 127) ? 127 : (raw < -128) ? -128 : raw;
+    word.range(slot * 8 + 7, slot * 8) = q;
+}
+
+/* =========================================================================
+ * ACTIVATION STATISTICS (stats_dram, see STAT_* in conv_engine.h)
+ *
+ * act_clipped: the value insert_act stores is not the value it was given
+ *   — int8 overflow after rounding (ACT8), or a data_t rail (16-bit: the
+ *   epilogue / residual add already saturated it).
+ * act_bin: histogram bin = bit length of |raw|, clamped to the top bin.
+ * Verilog analogy: a comparator pair and a priority encoder per lane.
+ * ========================================================================= */
+static inline bool act_clipped(data_t val, int act_shift) {
+    #pragma HLS INLINE
+    int raw = (ap_int<16>)val.range(15, 0);
+    if (act_shift < 0) return raw == 32767 || raw == -32768;
+    if (act_shift > 0) raw += 1 << (act_shift - 1);
+    raw >>= act_shift;
+    return raw > 127 || raw < -128;
+}
+
+static inline int act_bin(data_t val) {
+    #pragma HLS INLINE
+    int raw = (ap_int<16>)val.range(15, 0);
+    int mag = (raw < 0) ? -raw : raw;
+    int bin = 0;
+    STAT_BIN: for (int b = 1; b < STAT_BINS; b++) {
+        #pragma HLS UNROLL
+        if (mag >= (1 << (b - 1))) bin = b;
+    }
+    return bin;
+}
+
+/* =========================================================================
+ * STAGE 1a: FETCH LAYER — INPUT ACTIVATIONS (IC-OUTER)
  *
  * KEY FIX: Input cache is filled ONCE per IC tile, then REUSED across
  * all OC tiles. This eliminates redundant DRAM reads that caused
  * 96% wasted cycles in the previous OC-outer design.
  *
- * Loop order: ROW → COL → IC → OC  (was ROW → COL → OC → IC)
+ * Loop order: ROW → COL → IC  (weights live in Fetch_Weights)
  *
  *  ┌──────────┐     ┌───────────┐     ┌─────────────┐
  *  │  DRAM    │────→│ DMA line  │────→│ input_cache  │────→ stream
- *  │ (m_axi)  │     │ buf [4]   │     │ [16][35][35] │  (reused ×OC)
+ *  │ (m_axi)  │     │ buf [4]   │     │ [16][33][33] │  (reused ×OC)
  *  └──────────┘     └───────────┘     └─────────────┘
  *
+ * ROW-STRIP MODE (one IC tile, or several at stride 2; every IC tile's
+ * strip rows × padded width ≤ STRIP_ELEMS): a full-width strip per IC
+ * tile is loaded once per ROW tile with one long burst per input row.  The bottom K - stride rows are shifted up for the next
+ * strip, so each input row is read from DRAM exactly once, and column
+ * tiles stream straight from the strip (no per-tile halo refetch).  At
+ * stride 2 this replaces 33 short bursts per IC lane per tile with 32
+ * long ones per strip.
+ *
+ *  ┌──────────┐     ┌────────────┐     ┌──────────────┐
+ *  │  DRAM    │────→│ DMA strip  │────→│ strip_cache   │────→ stream
+ *  │ (m_axi)  │     │ buf [28]   │     │ [16][18·418]  │  (all COL tiles)
+ *  └──────────┘     └────────────┘     └──────────────┘
+ *
+ * COLUMN-HALO REUSE (tiled path, row-major tile order): adjacent column
+ * tiles share K - stride input columns (a tile's window is
+ * (curr_w-1)·stride + K wide and the next one starts TILE_W·stride
+ * further on).  After filling a tile, those right-edge
+ * columns are saved per IC tile in halo_cache; the next column tile
+ * restores them during FILL_CLEAR and bursts only the new columns.
+ *
+ * CHANNEL REMAP (use_chan_map=1): IC tiles are built from the compacted
+ * active-channel list; ic_plane[] turns each one into its DRAM plane, so
+ * a pruned layer still fills every IC lane without host repacking.
+ *
+ * PLANE MODE (one tile covers the whole map, plane ≤ PLANE_MAX_ELEMS,
+ * i.e. the 13×13 layers): a row is only 13 elements, so per-row bursts
+ * are pure AXI latency.  Instead each channel's whole plane (169 elements,
+ * 11 words) is read in ONE burst and scattered into input_cache.
+ *
+ *  ┌──────────┐     ┌────────────┐     ┌─────────────┐
+ *  │  DRAM    │────→│ DMA plane  │────→│ input_cache  │────→ stream
+ *  │ (m_axi)  │     │ buf [17]   │     │ [16][33][33] │
+ *  └──────────┘     └────────────┘     └─────────────┘
+ *
+ * ACT8 INPUT (in_act_shift ≥ 0): the map is int8, 32 per word, so the
+ * address decode uses >>5 / &31 and each burst is half as long; the
+ * scatter widens every byte back to data_t (extract_act).
+ *
+ * INPUT VIEW: the in_height × in_width input is a window of a larger
+ * tensor.  Element (c, r, x) lives at
+ *     (in_ic_offset + c)·plane_pitch + r·row_pitch + view_origin + x
+ * (c remapped through ic_map_dram when use_chan_map),
+ * so a channel slice of a concat, a crop of a bigger frame, or half the
+ * channels for a multi-CU split is read in place.  Plane mode needs
+ * contiguous rows (row_pitch == in_width).
+ *
+ * DEPTHWISE (depthwise=1): Execute gathers the K×K taps itself, so Phase D
+ * streams the tile's tile_in_h × tile_in_w input window once, row-major,
+ * instead of K² shifted copies of the output grid (9× fewer beats at K=3).
+ *
+ * STRIDED WINDOW (stride ≥ 2): the shifted copies barely overlap, so the
+ * window is streamed once here too and Execute picks each tap out of it
+ * (33×33 vs 9 × 16×16 beats per full 3×3 tile — 2.1× fewer, and as many
+ * fewer cycles in Execute's input load, which is not overlapped with its
+ * MAC passes).
+ *
  * ========================================================================= */
 void Fetch_Layer(
     wide_t* input_dram,
-    wide_t* weights_dram,
-    hls::stream<vec_t>& input_stream,
-    hls::stream<vec_t>& weight_stream,
-    int in_channels, int out_channels,
+    int*    ic_map_dram,
+    vec_stream_t& input_stream,
+    int in_channels,
     int in_height,   int in_width,
-    int kernel_size,  int stride, int padding,
-    int out_height,   int out_width
+    int kernel_size,  int stride,
+    int pad_top,      int pad_left, int pad_right,
+    int out_height,   int out_width,
+    int grid_h,       int grid_w,   int tile_ovl,
+    int use_chan_map, int in_act_shift,
+    int in_ic_offset, int row_pitch, int plane_pitch, int view_origin,
+    int depthwise
 ) {
-    int tr_steps = (out_height + TILE_H - 1) / TILE_H;
-    int tc_steps = (out_width  + TILE_W - 1) / TILE_W;
-    int to_steps = (out_channels + TILE_OC - 1) / TILE_OC;
+    PROF_STAGE("Fetch_Layer");
+    int step_h   = TILE_H - tile_ovl;
+    int step_w   = TILE_W - tile_ovl;
+    int tr_steps = (grid_h + step_h - 1) / step_h;
+    int tc_steps = (grid_w + step_w - 1) / step_w;
     int ti_steps = (in_channels  + TILE_IC - 1) / TILE_IC;
 
+    /* ---- Element → word decode: 16 (data_t) or 32 (ACT8) per word ---- */
+    int es = (in_act_shift >= 0) ? 5 : 4;
+    int em = (1 << es) - 1;
+
+    /* ---- Channel remap: compacted IC → DRAM plane (identity if off),
+     *      offset to the view's first channel ---- */
+    int ic_plane[MAX_CHANNELS];
+    LOAD_IC_MAP: for (int i = 0; i < in_channels; i++) {
+    #pragma HLS LOOP_TRIPCOUNT min=3 max=1024 avg=256
+        #pragma HLS PIPELINE II=1
+        ic_plane[i] = in_ic_offset + (use_chan_map ? ic_map_dram[i] : i);
+    }
+    PROF_CYCLES((use_chan_map ? PROF_AXI_LATENCY : 0) + in_channels);
+
     /* ---- On-chip BRAM caches ---- */
     data_t input_cache[TILE_IC][CACHE_H][CACHE_W];
     #pragma HLS ARRAY_PARTITION variable=input_cache dim=1 complete
     #pragma HLS BIND_STORAGE variable=input_cache type=ram_2p impl=bram
 
-    data_t weight_cache[TILE_OC][TILE_IC][K_MAX][K_MAX];
-    #pragma HLS ARRAY_PARTITION variable=weight_cache dim=1 complete
-    #pragma HLS ARRAY_PARTITION variable=weight_cache dim=2 complete
-
     /* ---- DMA staging buffers ---- */
     wide_t dma_line[DMA_LINE_WORDS];
     #pragma HLS ARRAY_PARTITION variable=dma_line complete
 
-    wide_t dma_wt[DMA_WT_WORDS];
-    #pragma HLS ARRAY_PARTITION variable=dma_wt complete
+    /* ---- Row-strip cache + staging (see header comment); row r of the
+     *      strip starts at r·strip_w ---- */
+    data_t strip_cache[TILE_IC][STRIP_ELEMS];
+    #pragma HLS ARRAY_PARTITION variable=strip_cache dim=1 complete
+    #pragma HLS BIND_STORAGE variable=strip_cache type=ram_2p impl=bram
+
+    wide_t dma_strip[DMA_STRIP_WORDS];
+
+    /* One strip per IC tile, each strip_rows × strip_w.  Several IC tiles
+     * only at stride ≥ 2 with column tiles to share a strip: stride-1
+     * layers that deep have OC loops long enough to hide the per-tile
+     * fetch, and loading all the strips at column 0 stalls them instead */
+    int  strip_w    = pad_left + in_width + pad_right;
+    int  strip_rows = (TILE_H - 1) * stride + kernel_size;
+    int  strip_size = strip_rows * strip_w;
+    bool strip_mode = !tile_ovl && (ti_steps * strip_size <= STRIP_ELEMS)
+                   && (ti_steps == 1 || (stride > 1 && tc_steps > 1));
+
+    /* ---- Column-halo store: right-edge K - stride columns per IC tile ---- */
+    data_t halo_cache[HALO_IC_TILES][TILE_IC][CACHE_H][K_MAX - 1];
+    #pragma HLS ARRAY_PARTITION variable=halo_cache dim=2 complete
+
+    int  halo      = kernel_size - stride;
+    bool halo_mode = !strip_mode && !tile_ovl && (halo > 0) && (tc_steps > 1)
+                  && (ti_steps <= HALO_IC_TILES);
+
+    /* ---- Plane mode: whole channel plane in one burst ---- */
+    wide_t dma_plane[DMA_PLANE_WORDS];
+
+    /* ---- Window streaming: Execute gathers taps from the raw window ---- */
+    bool win_mode    = depthwise || (stride > 1);
+
+    int  plane_elems = in_height * in_width;
+    bool plane_mode  = !strip_mode && (tr_steps == 1) && (tc_steps == 1)
+                    && (plane_elems <= PLANE_MAX_ELEMS) && (row_pitch == in_width);
 
     /* ==== MAIN TILE LOOPS — IC-OUTER, OC-INNER ==== */
     ROW_TILE: for (int tr = 0; tr < tr_steps; tr++) {
@@ -122,69 +392,211 @@ void Fetch_Layer(
         COL_TILE: for (int tc = 0; tc < tc_steps; tc++) {
         #pragma HLS LOOP_TRIPCOUNT min=1 max=26 avg=8
 
-            int r_start = tr * TILE_H;
-            int c_start = tc * TILE_W;
+            int r_start = tr * step_h;
+            int c_start = tc * step_w;
             int curr_h  = (r_start + TILE_H > out_height) ? out_height - r_start : TILE_H;
             int curr_w  = (c_start + TILE_W > out_width)  ? out_width  - c_start : TILE_W;
-            int tile_in_h = curr_h * stride + kernel_size - 1;
-            int tile_in_w = curr_w * stride + kernel_size - 1;
-            int h_base = r_start * stride - padding;
-            int w_base = c_start * stride - padding;
+            int tile_in_h = (curr_h - 1) * stride + kernel_size;
+            int tile_in_w = (curr_w - 1) * stride + kernel_size;
+            int h_base = r_start * stride - pad_top;
+            int w_base = c_start * stride - pad_left;
 
             IC_TILE: for (int ti = 0; ti < ti_steps; ti++) {
             #pragma HLS LOOP_TRIPCOUNT min=1 max=64 avg=16
                 int ic_base = ti * TILE_IC;
-                int ic_valid = (ic_base + TILE_IC > in_channels)
-                             ? (in_channels - ic_base) : TILE_IC;
+                int strip_b = ti * strip_size + c_start * stride;  /* window in strip */
+                bool reuse_halo = halo_mode && (tc > 0);
+                bool save_halo  = halo_mode && (tc < tc_steps - 1);
+
+                /* ============================================================
+                 * PHASE S: Row-strip load (strip mode, once per ROW tile
+                 * and IC tile, so it overlaps the previous IC tile's
+                 * compute).  Carry the K - stride halo rows, then
+                 * burst-read each new padded row in one transaction (up
+                 * to 27 words vs ≤4 per tile row).
+                 * ============================================================ */
+                if (strip_mode && tc == 0) {
+                    int strip_halo = (kernel_size > stride) ? kernel_size - stride : 0;
+                    int first      = (tr == 0) ? 0 : strip_halo;
+                    int sb         = ti * strip_size;
+                    int carry_off  = TILE_H * stride * strip_w;
+
+                    STRIP_SHIFT: for (int e = 0; e < first * strip_w; e++) {
+                    #pragma HLS LOOP_TRIPCOUNT min=0 max=836 avg=420
+                        #pragma HLS PIPELINE II=1
+                        STRIP_SHIFT_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                            #pragma HLS UNROLL
+                            strip_cache[ic][sb + e] = strip_cache[ic][sb + carry_off + e];
+                        }
+                    }
+                    PROF_CYCLES(first * strip_w);
+
+                    STRIP_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                        int  abs_ic = ic_base + ic;
+                        bool ic_valid_flag = (abs_ic < in_channels);
+
+                        /* A lane past in_channels is never written after
+                         * the first (tallest) strip clears it; the shift
+                         * above carries its zeros */
+                        if (!ic_valid_flag && tr > 0)
+                            continue;
+
+                        STRIP_ROW: for (int i = first; i < tile_in_h; i++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=16
+                            int r_idx = h_base + i;
+                            bool row_ok = ic_valid_flag
+                                       && (r_idx >= 0) && (r_idx < in_height);
+                            int row_base   = ic_plane[ic_valid_flag ? abs_ic : 0] * plane_pitch
+                                           + r_idx * row_pitch + view_origin;
+                            int first_word = row_base >> es;
+
+                            if (row_ok) {
+                                int last_word = (row_base + in_width - 1) >> es;
+                                int n_words   = last_word - first_word + 1;
+
+                                DMA_STRIP_BURST: for (int w = 0; w < n_words; w++) {
+                                #pragma HLS LOOP_TRIPCOUNT min=1 max=27 avg=14
+                                    #pragma HLS PIPELINE II=1
+                                    dma_strip[w] = input_dram[first_word + w];
+                                }
+                                PROF_CYCLES(PROF_AXI_LATENCY + n_words);
+                            }
+
+                            /* One pass over the padded row: pad columns (and
+                             * whole pad rows) are written as zero, the rest
+                             * scattered from the burst */
+                            SCATTER_STRIP: for (int j = 0; j < strip_w; j++) {
+                            #pragma HLS LOOP_TRIPCOUNT min=1 max=418 avg=210
+                                #pragma HLS PIPELINE II=1
+                                int x = j - pad_left;
+                                int abs_idx = row_base + x;
+                                data_t v = (data_t)0;
+                                if (row_ok && x >= 0 && x < in_width)
+                                    v = extract_act(dma_strip[(abs_idx >> es) - first_word],
+                                                    abs_idx & em, in_act_shift);
+                                strip_cache[ic][sb + i * strip_w + j] = v;
+                            }
+                            PROF_CYCLES(strip_w);
+                        }
+                    }
+                }
 
                 /* ============================================================
                  * PHASE A: DMA burst-read input tile → input_cache
                  * Happens ONCE per IC tile — shared across ALL OC tiles.
                  * This is the key fix: was previously inside OC loop.
+                 * Skipped in strip mode: the strip already holds the tile.
+                 * Plane mode: one burst per channel instead of per row.
                  * ============================================================ */
-                FILL_IC: for (int ic = 0; ic < TILE_IC; ic++) {
-                    int abs_ic = ic_base + ic;
-                    bool ic_valid_flag = (abs_ic < in_channels);
-
-                    FILL_ROW: for (int i = 0; i < tile_in_h; i++) {
-                    #pragma HLS LOOP_TRIPCOUNT min=1 max=35 avg=18
-                        int r_idx = h_base + i;
-                        bool row_ok = ic_valid_flag
-                                   && (r_idx >= 0) && (r_idx < in_height);
-
-                        FILL_CLEAR: for (int j = 0; j < tile_in_w; j++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=35 avg=18
-                            #pragma HLS PIPELINE II=1
-                            input_cache[ic][i][j] = (data_t)0;
+                if (plane_mode) {
+                    PLANE_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                        int abs_ic = ic_base + ic;
+
+                        PLANE_CLEAR_ROW: for (int i = 0; i < tile_in_h; i++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=15
+                            PLANE_CLEAR_COL: for (int j = 0; j < tile_in_w; j++) {
+                            #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=15
+                                #pragma HLS PIPELINE II=1
+                                input_cache[ic][i][j] = (data_t)0;
+                            }
                         }
+                        PROF_CYCLES(tile_in_h * tile_in_w);
 
-                        if (row_ok) {
+                        if (abs_ic < in_channels) {
+                            int plane_base = ic_plane[abs_ic] * plane_pitch + view_origin;
+                            int first_word = plane_base >> es;
+                            int last_word  = (plane_base + plane_elems - 1) >> es;
+                            int n_words    = last_word - first_word + 1;
+
+                            DMA_PLANE_BURST: for (int w = 0; w < n_words; w++) {
+                            #pragma HLS LOOP_TRIPCOUNT min=1 max=17 avg=11
+                                #pragma HLS PIPELINE II=1
+                                dma_plane[w] = input_dram[first_word + w];
+                            }
+                            PROF_CYCLES(PROF_AXI_LATENCY + n_words);
+
+                            /* (r, c) lands at cache (r - h_base, c - w_base);
+                             * rows/cols the kernel never reaches are dropped */
+                            SCATTER_PLANE_R: for (int r = 0; r < in_height; r++) {
+                            #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=13
+                                SCATTER_PLANE_C: for (int c = 0; c < in_width; c++) {
+                                #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=13
+                                    #pragma HLS PIPELINE II=1
+                                    int i = r - h_base;
+                                    int j = c - w_base;
+                                    int abs_idx = plane_base + r * in_width + c;
+                                    if (i < tile_in_h && j < tile_in_w)
+                                        input_cache[ic][i][j] = extract_act(
+                                            dma_plane[(abs_idx >> es) - first_word],
+                                            abs_idx & em, in_act_shift);
+                                }
+                            }
+                            PROF_CYCLES(plane_elems);
+                        }
+                    }
+                } else if (!strip_mode) {
+                    FILL_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                        int abs_ic = ic_base + ic;
+                        bool ic_valid_flag = (abs_ic < in_channels);
+
+                        /* With one IC tile, a lane past in_channels is never
+                         * written after the first (largest) tile clears it */
+                        if (!ic_valid_flag && ti_steps == 1 && (tr > 0 || tc > 0))
+                            continue;
+
+                        FILL_ROW: for (int i = 0; i < tile_in_h; i++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=18
+                            int r_idx = h_base + i;
+                            bool row_ok = ic_valid_flag
+                                       && (r_idx >= 0) && (r_idx < in_height);
+
+                            /* Columns [c_lo, c_hi) come from DRAM; the rest
+                             * are padding or the shared left halo */
                             int c_lo = (w_base < 0) ? -w_base : 0;
-                            int c_hi = (w_base + tile_in_w > in_width)
+                            if (reuse_halo && c_lo < halo) c_lo = halo;
+                            int c_hi = !row_ok ? c_lo
+                                     : (w_base + tile_in_w > in_width)
                                      ? (in_width - w_base) : tile_in_w;
+                            int row_base   = ic_plane[abs_ic < in_channels ? abs_ic : 0] * plane_pitch
+                                           + r_idx * row_pitch + view_origin;
+                            int first_word = (row_base + w_base + c_lo) >> es;
 
                             if (c_lo < c_hi) {
-                                int row_base  = (abs_ic * in_height + r_idx) * in_width;
-                                int elem_lo   = row_base + w_base + c_lo;
-                                int elem_hi   = row_base + w_base + c_hi - 1;
-                                int first_word = elem_lo >> 4;
-                                int last_word  = elem_hi >> 4;
-                                int n_words    = last_word - first_word + 1;
+                                int last_word = (row_base + w_base + c_hi - 1) >> es;
+                                int n_words   = last_word - first_word + 1;
 
                                 DMA_IN_BURST: for (int w = 0; w < n_words; w++) {
                                 #pragma HLS LOOP_TRIPCOUNT min=1 max=4 avg=2
                                     #pragma HLS PIPELINE II=1
                                     dma_line[w] = input_dram[first_word + w];
                                 }
+                                PROF_CYCLES(PROF_AXI_LATENCY + n_words);
+                            }
 
-                                SCATTER_IN: for (int j = c_lo; j < c_hi; j++) {
-                                #pragma HLS LOOP_TRIPCOUNT min=1 max=35 avg=16
+                            /* One pass over the row: clear and scatter fused */
+                            FILL_COL: for (int j = 0; j < tile_in_w; j++) {
+                            #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=18
+                                #pragma HLS PIPELINE II=1
+                                int abs_idx = row_base + w_base + j;
+                                data_t v = (data_t)0;
+                                if (reuse_halo && j < halo)
+                                    v = halo_cache[ti][ic][i][j];
+                                else if (j >= c_lo && j < c_hi)
+                                    v = extract_act(dma_line[(abs_idx >> es) - first_word],
+                                                    abs_idx & em, in_act_shift);
+                                input_cache[ic][i][j] = v;
+                            }
+                            PROF_CYCLES(tile_in_w);
+
+                            /* Keep the right edge for the next column tile */
+                            if (save_halo) {
+                                HALO_SAVE: for (int j = 0; j < halo; j++) {
+                                #pragma HLS LOOP_TRIPCOUNT min=0 max=2 avg=2
                                     #pragma HLS PIPELINE II=1
-                                    int abs_idx = row_base + w_base + j;
-                                    int wi = (abs_idx >> 4) - first_word;
-                                    int si =  abs_idx & 0xF;
-                                    input_cache[ic][i][j] = extract_elem(dma_line[wi], si);
+                                    halo_cache[ti][ic][i][j] =
+                                        input_cache[ic][i][tile_in_w - halo + j];
                                 }
+                                PROF_CYCLES(halo);
                             }
                         }
                     }
@@ -194,105 +606,239 @@ void Fetch_Layer(
                  * PHASE D: Stream inputs → Execute (ONCE per IC tile)
                  * Previously inside OC loop — moved here for 2-64× fewer
                  * stream writes.  Execute caches locally and reuses ×OC.
+                 * Depthwise / stride ≥ 2: the raw input window, one beat per
+                 * pixel.
                  * ============================================================ */
-                STREAM_IN_KY: for (int ky = 0; ky < kernel_size; ky++) {
-                #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                    STREAM_IN_KX: for (int kx = 0; kx < kernel_size; kx++) {
+                if (win_mode) {
+                    STREAM_WIN_R: for (int r = 0; r < tile_in_h; r++) {
+                    #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=18
+                        STREAM_WIN_C: for (int c = 0; c < tile_in_w; c++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=18
+                            #pragma HLS PIPELINE II=1
+                            vec_t in_vec;
+                            PACK_WIN_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                                #pragma HLS UNROLL
+                                data_t v = strip_mode
+                                         ? strip_cache[ic][strip_b + r * strip_w + c]
+                                         : input_cache[ic][r][c];
+                                in_vec.range(ic*16+15, ic*16) = v.range(15, 0);
+                            }
+                            input_stream.write(in_vec);
+                        }
+                    }
+                } else {
+                    STREAM_IN_KY: for (int ky = 0; ky < kernel_size; ky++) {
                     #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                        STREAM_IN_I: for (int i = 0; i < curr_h; i++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                            STREAM_IN_J: for (int j = 0; j < curr_w; j++) {
+                        STREAM_IN_KX: for (int kx = 0; kx < kernel_size; kx++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
+                            STREAM_IN_I: for (int i = 0; i < curr_h; i++) {
                             #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                                #pragma HLS PIPELINE II=1
-                                vec_t in_vec;
-                                PACK_IN_IC: for (int ic = 0; ic < TILE_IC; ic++) {
-                                    #pragma HLS UNROLL
-                                    int row = i * stride + ky;
-                                    int col = j * stride + kx;
-                                    in_vec.range(ic*16+15, ic*16) =
-                                        input_cache[ic][row][col].range(15, 0);
+                                STREAM_IN_J: for (int j = 0; j < curr_w; j++) {
+                                #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
+                                    #pragma HLS PIPELINE II=1
+                                    vec_t in_vec;
+                                    PACK_IN_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                                        #pragma HLS UNROLL
+                                        int row = i * stride + ky;
+                                        int col = j * stride + kx;
+                                        data_t v = strip_mode
+                                                 ? strip_cache[ic][strip_b + row * strip_w + col]
+                                                 : input_cache[ic][row][col];
+                                        in_vec.range(ic*16+15, ic*16) = v.range(15, 0);
+                                    }
+                                    input_stream.write(in_vec);
                                 }
-                                input_stream.write(in_vec);
                             }
                         }
                     }
                 }
+            } /* IC_TILE */
+        }
+    }
+}
+
+/* One pre-tiled weight block → weight_stream: the two header beats, then
+ * nw weight words (W8A16: one word → two widened beats, an odd depthwise
+ * block pads its last word).  src is DRAM (one burst) or the on-chip
+ * prefetch stage. */
+static inline void stream_wt_block(const wide_t* src, vec_stream_t& weight_stream,
+                                   int beats, int nw, int wt_int8) {
+    #pragma HLS INLINE
+    /* ---- Header: bias beat, scale beat (16-bit lanes) ---- */
+    WT_HDR: for (int h = 0; h < WT_HDR_BEATS; h++) {
+        #pragma HLS PIPELINE II=1
+        weight_stream.write((vec_t)src[h]);
+    }
+    src += WT_HDR_BEATS;
+
+    if (wt_int8) {
+        WT_BURST_I8: for (int w = 0; w < nw; w++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=72 avg=72
+            #pragma HLS PIPELINE II=2
+            wide_t word = src[w];
+            WT_HALF: for (int h = 0; h < 2; h++) {
+                vec_t w_vec;
+                WIDEN_WT_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                    #pragma HLS UNROLL
+                    w_vec.range(ic*16+15, ic*16) =
+                        extract_wt8(word, h * TILE_IC + ic).range(15, 0);
+                }
+                if (2 * w + h < beats) weight_stream.write(w_vec);
+            }
+        }
+    } else {
+        /* ---- One contiguous burst, word = beat ---- */
+        WT_BURST: for (int w = 0; w < nw; w++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=144 avg=144
+            #pragma HLS PIPELINE II=1
+            weight_stream.write((vec_t)src[w]);
+        }
+    }
+}
+
+/* =========================================================================
+ * STAGE 1b: FETCH WEIGHTS — SEPARATE DATAFLOW PROCESS
+ *
+ * Walks the same ROW → COL → IC → OC tile order as Execute_Layer and
+ * streams one 16 OC × 16 IC × K×K weight block per OC tile.  Running as
+ * its own process on its own AXI port (gmem2), it fills weight_stream
+ * ahead of Execute by up to WEIGHT_STREAM_DEPTH / (16·K·K) OC tiles, so
+ * weight DMA latency overlaps input fetch and compute instead of sitting
+ * between compute passes.
+ *
+ * Weights are pre-tiled by the host (see WT_BLOCK_WORDS): each (OC tile,
+ * IC tile) block is contiguous and every 256-bit word is already one
+ * stream beat (16 IC lanes of one oc/ky/kx).  So a block is ONE burst of
+ * WT_HDR_BEATS + 16·K·K words straight into the FIFO — no per-OC address
+ * decode, no element unpack, and the FIFO itself is the staging buffer.
+ * The two header beats (per-OC bias, per-OC scale word) replace the old
+ * 16-bit BN port.
+ *
+ *  ┌──────────┐     ┌──────────────────────┐
+ *  │  DRAM    │────→│ weight_stream (FIFO)  │────→ Execute
+ *  │ (gmem2)  │     │ 1 burst / tile pair   │  (runs ahead)
+ *  └──────────┘     └──────────────────────┘
+ *
+ * W8A16 (wt_int8=1): DRAM holds int8 weights, so after the 16-bit header
+ * a word carries two beats (low 16 bytes first).  Each byte is widened to data_t
+ * (extract_wt8); the stream, MAC array and activations are unchanged
+ * while gmem2 traffic per block halves.
+ *
+ * GROUPS: IC tile ti only meets the tpg_o OC tiles of its own group, and
+ * its block within each is ti's index inside the group.  A depthwise layer
+ * is one "group" per channel tile with a K²-beat block (lane = channel).
+ *
+ * CROSS-INVOCATION PREFETCH: once the last block is in the FIFO, the
+ * process is idle while Execute and Write finish the layer.  It spends
+ * that time copying the NEXT layer's first next_wt_blocks blocks
+ * (next_wt_blk_words each, next_wt_stride apart: IC tile 0's OC run, the
+ * order they are consumed) into wt_stage, which keeps its contents
+ * between invocations (static).  The next call sets wt_staged=1, and its
+ * first tile pass streams those blocks from BRAM — Execute starts without
+ * waiting on gmem2.  The stage is tagged with the block size and pitch it
+ * was filled with, and a layer whose own differ ignores it; conv_layer
+ * also drops it for any call in between that does not refill it (fused
+ * mode, a rejected layer), so it only ever feeds the layer right after.
+ *
+ *  ┌──────────┐    ┌──────────┐
+ *  │  DRAM    │───→│ wt_stage │───→ weight_stream   (next call, first
+ *  │ (gmem2)  │    │ [1024]   │                      tile pass only)
+ *  └──────────┘    └──────────┘
+ *     ↑ next_weights_dram, after this layer's last block
+ *
+ * ========================================================================= */
+void Fetch_Weights(
+    wide_t* weights_dram,
+    wide_t* next_weights_dram,
+    vec_stream_t& weight_stream,
+    int in_channels, int out_channels,
+    int kernel_size,
+    int grid_h,       int grid_w,   int tile_ovl,
+    int wt_int8,      int groups,
+    int next_wt_blocks, int next_wt_blk_words, int next_wt_stride,
+    int wt_staged
+) {
+    PROF_STAGE("Fetch_Weights");
+    int tr_steps = (grid_h + TILE_H - tile_ovl - 1) / (TILE_H - tile_ovl);
+    int tc_steps = (grid_w + TILE_W - tile_ovl - 1) / (TILE_W - tile_ovl);
+    int to_steps = (out_channels + TILE_OC - 1) / TILE_OC;
+    int ti_steps = (in_channels  + TILE_IC - 1) / TILE_IC;
+
+    /* ---- Tile groups: tpg_i IC tiles × tpg_o OC tiles each ---- */
+    bool dw      = (groups > 1) && (groups == in_channels);
+    int  t_grps  = dw ? ti_steps : groups;
+    int  tpg_i   = ti_steps / t_grps;
+    int  tpg_o   = to_steps / t_grps;
+
+    int kk       = kernel_size * kernel_size;
+    int beats    = dw ? kk : TILE_OC * kk;                /* per block    */
+    int nw       = wt_int8 ? (beats + 1) >> 1 : beats;    /* weight words */
+    int blk      = WT_HDR_BEATS + nw;                     /* DRAM words   */
+
+    /* ---- Prefetch stage: survives between invocations ---- */
+    static wide_t wt_stage[WT_STAGE_WORDS];
+    static int    stage_n     = 0;      /* blocks held              */
+    static int    stage_blk   = 0;      /* words per held block     */
+    static int    stage_pitch = 0;      /* DRAM words between them  */
+    #pragma HLS BIND_STORAGE variable=wt_stage type=ram_2p impl=bram
+    bool staged = wt_staged && stage_blk == blk
+               && (stage_n <= 1 || stage_pitch == tpg_i * blk);
+
+    WT_ROW_TILE: for (int tr = 0; tr < tr_steps; tr++) {
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=26 avg=8
+        WT_COL_TILE: for (int tc = 0; tc < tc_steps; tc++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=26 avg=8
+            WT_IC_TILE: for (int ti = 0; ti < ti_steps; ti++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=64 avg=16
+                int g    = ti / tpg_i;
+                int ti_l = ti - g * tpg_i;
 
                 /* ============================================================
                  * Iterate OC tiles — only WEIGHTS streamed per OC tile.
-                 * CLEAR_WT removed: stale weights × zero-padded input = 0,
-                 * and invalid OC outputs are discarded by Write_Layer.
-                 * sdiv/srem replaced with nested ky/kx loops.
+                 * Padded OC/IC lanes are zero in the pre-tiled layout, and
+                 * invalid OC outputs are discarded by Write_Layer anyway.
                  * ============================================================ */
-                OC_TILE: for (int to = 0; to < to_steps; to++) {
+                OC_TILE: for (int to = g * tpg_o; to < (g + 1) * tpg_o; to++) {
                 #pragma HLS LOOP_TRIPCOUNT min=1 max=64 avg=16
-                    int oc_base = to * TILE_OC;
-                    int oc_valid = (oc_base + TILE_OC > out_channels)
-                                 ? (out_channels - oc_base) : TILE_OC;
+                    int base = (to * tpg_i + ti_l) * blk;
 
-                    /* ---- Load weights for this (OC, IC) pair ---- */
-                    LD_WT_OC: for (int oc = 0; oc < oc_valid; oc++) {
-                    #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                        int oc_abs = oc_base + oc;
-                        int block_start = (oc_abs * in_channels + ic_base) * kernel_size * kernel_size;
-                        int block_elems = ic_valid * kernel_size * kernel_size;
-                        int fw = block_start >> 4;
-                        int lw = (block_start + block_elems - 1) >> 4;
-                        int nw = lw - fw + 1;
-
-                        DMA_WT_BURST: for (int w = 0; w < nw; w++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=12 avg=9
-                            #pragma HLS PIPELINE II=1
-                            dma_wt[w] = weights_dram[fw + w];
-                        }
-
-                        UNPACK_WT_IC: for (int ic = 0; ic < ic_valid; ic++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                            UNPACK_WT_KY: for (int ky = 0; ky < kernel_size; ky++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                                UNPACK_WT_KX: for (int kx = 0; kx < kernel_size; kx++) {
-                                #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                                    #pragma HLS PIPELINE II=1
-                                    int flat = block_start
-                                             + ic * kernel_size * kernel_size
-                                             + ky * kernel_size + kx;
-                                    int wi = (flat >> 4) - fw;
-                                    int si =  flat & 0xF;
-                                    weight_cache[oc][ic][ky][kx]
-                                        = extract_elem(dma_wt[wi], si);
-                                }
-                            }
-                        }
-                    }
-
-                    /* ---- Stream weights → Execute ---- */
-                    STREAM_WT_OC: for (int oc = 0; oc < TILE_OC; oc++) {
-                        STREAM_WT_KY: for (int ky = 0; ky < kernel_size; ky++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                            STREAM_WT_KX: for (int kx = 0; kx < kernel_size; kx++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                                #pragma HLS PIPELINE II=1
-                                vec_t w_vec;
-                                PACK_WT_IC: for (int ic = 0; ic < TILE_IC; ic++) {
-                                    #pragma HLS UNROLL
-                                    w_vec.range(ic*16+15, ic*16) =
-                                        weight_cache[oc][ic][ky][kx].range(15, 0);
-                                }
-                                weight_stream.write(w_vec);
-                            }
-                        }
+                    /* The layer's first blocks may already be on chip */
+                    if (staged && tr == 0 && tc == 0 && ti == 0 && to < stage_n) {
+                        stream_wt_block(wt_stage + to * blk, weight_stream,
+                                        beats, nw, wt_int8);
+                    } else {
+                        stream_wt_block(weights_dram + base, weight_stream,
+                                        beats, nw, wt_int8);
+                        PROF_CYCLES(PROF_AXI_LATENCY);
                     }
 
                 } /* OC_TILE */
-            } /* IC_TILE */
+            } /* WT_IC_TILE */
         }
     }
+
+    /* ====== Prefetch the next layer's first blocks (whole blocks that
+     *        fit; 0 blocks empties the stage) ====== */
+    int pf_n = (next_wt_blocks > 0 && next_wt_blk_words > 0)
+             ? WT_STAGE_WORDS / next_wt_blk_words : 0;
+    if (pf_n > next_wt_blocks) pf_n = next_wt_blocks;
+    int pf_q = 0, pf_o = 0;
+    WT_PREFETCH: for (int w = 0; w < pf_n * next_wt_blk_words; w++) {
+    #pragma HLS LOOP_TRIPCOUNT min=0 max=1024 avg=876
+        #pragma HLS PIPELINE II=1
+        wt_stage[w] = next_weights_dram[pf_q * next_wt_stride + pf_o];
+        if (++pf_o == next_wt_blk_words) { pf_o = 0; pf_q++; }
+    }
+    stage_n     = pf_n;
+    stage_blk   = next_wt_blk_words;
+    stage_pitch = next_wt_stride;
+    PROF_CYCLES(pf_n ? PROF_AXI_LATENCY + pf_n * next_wt_blk_words : 0);
 }
 
 /* =========================================================================
  * STAGE 2: EXECUTE LAYER — IC-OUTER / OC-INNER with PSUM BUFFER
  *
- * Loop order: ROW → COL → IC → OC  (matches Fetch_Layer)
+ * Loop order: ROW → COL → IC → OC  (matches Fetch_Layer / Fetch_Weights)
  *
  * Because IC is the outer loop, partial sums must persist across IC tiles.
  * psum_buf[MAX_OC_STEPS][TILE_OC][TILE_H][TILE_W] in BRAM stores
@@ -301,41 +847,142 @@ void Fetch_Layer(
  * On the last IC tile, BN + Activate + Stream Out is performed.
  *
  * 256-MAC tree: 16 OC × 16 IC DSP-mapped multiplies per cycle at II=1.
+ *
+ * BN is folded into the weights by the host, so the epilogue is the W8A16
+ * dequant scale + add + activate: a shift and no DSPs, unless
+ * WT8_SCALE_MANT adds the mantissa multiply.  Per-OC bias and scale
+ * arrive as the two header beats of each weight block (the last IC
+ * tile's copy is used).
+ *
+ * Weight register file is double-buffered (ping-pong): while the MAC array
+ * computes with bank `cur`, the COMPUTE pipeline pulls the NEXT weight
+ * block (2 + 16·K·K beats) from weight_stream into bank `cur^1`, one beat per
+ * cycle.  Only the very first block is loaded up front; afterwards weight
+ * loading is hidden whenever a pass is at least 16 pixels long.
+ *
+ * Flattened pixel pass: the tile is walked as a 1D pixel list with
+ * row-wrapped (i, j) cursors, and all K×K taps run in ONE pipeline of
+ * K²·pixels iterations.  A 2D I/J nest restarts the MAC pipeline for every
+ * row of every tap (13 × 9 = 117 fill/drains per 13×13 pass); the flat pass
+ * pays one.  Pixels revisit an accumulator only once per tap sweep, so the
+ * sweep is padded with bubbles to ACC_RAW_DIST pixels on tiny edge tiles.
+ * PSUM load/save likewise walk only the tile's curr_h rows.
+ *
+ * 2×2 / stride-2 pooling runs in the epilogue: each output beat is the max
+ * of four activated pixels (zero past the conv edge, i.e. the pool pad),
+ * so only pooled pixels cross output_stream — 4× fewer beats, and Write
+ * no longer buffers pre-pool tiles.  Stride-1 pooling stays in Write.
+ *
+ * Stride ≥ 2: the input arrives as the raw window (see Fetch_Layer) and
+ * lands in dw_win, and the pass reads tap (ky, kx) of pixel (i, j) from
+ * window element (i·stride + ky, j·stride + kx) — one bank per cycle,
+ * where stride 1 reads the replicated input_lcl[ky][kx][i][j].
+ *
+ * Groups: IC tile ti accumulates only into the OC tiles of its group, so
+ * "first/last IC tile" is per group, and a group's OC tiles are emitted as
+ * soon as its last IC tile is done (still in ascending OC order).
+ * Depthwise turns the array sideways.  There is one OC tile per channel
+ * tile and the pass is one cycle per pixel.  The input window sits in
+ * dw_win; per pixel each of the DW_BANKS² banks is read once, at its own
+ * address, and the reads are routed to tap lanes:
+ *
+ *          IC lane t = (ky, kx)  →
+ *   OC c   w[c][t] · win[r0 + ky][c0 + kx].lane(c)   summed over t
+ *    ↓     (16 channels × K² taps, same DSPs and adder trees)
  * ========================================================================= */
 void Execute_Layer(
-    hls::stream<vec_t>& input_stream,
-    hls::stream<vec_t>& weight_stream,
-    hls::stream<vec_t>& output_stream,
-    data_t* bn_params,
+    vec_stream_t& input_stream,
+    vec_stream_t& weight_stream,
+    vec_stream_t& output_stream,
     int in_channels, int out_channels,
     int out_height,   int out_width,
-    int kernel_size,  int use_leaky
+    int grid_h,       int grid_w,   int tile_ovl,
+    int kernel_size,  int use_leaky,
+    int use_pool,     int pool_stride,
+    int pool_pad_bottom, int pool_pad_right,
+    int stride,       int groups
 ) {
-    int tr_steps = (out_height + TILE_H - 1) / TILE_H;
-    int tc_steps = (out_width  + TILE_W - 1) / TILE_W;
+    PROF_STAGE("Execute_Layer");
+    int step_h   = TILE_H - tile_ovl;
+    int step_w   = TILE_W - tile_ovl;
+    int tr_steps = (grid_h + step_h - 1) / step_h;
+    int tc_steps = (grid_w + step_w - 1) / step_w;
     int to_steps = (out_channels + TILE_OC - 1) / TILE_OC;
     int ti_steps = (in_channels  + TILE_IC - 1) / TILE_IC;
 
+    /* ---- Tile groups: tpg_i IC tiles × tpg_o OC tiles each ---- */
+    bool dw      = (groups > 1) && (groups == in_channels);
+    int  t_grps  = dw ? ti_steps : groups;
+    int  tpg_i   = ti_steps / t_grps;
+    int  tpg_o   = to_steps / t_grps;
+
+    /* ---- Epilogue 2×2 / stride-2 pool: pooled map dimensions ---- */
+    bool pool2   = use_pool && (pool_stride >= 2);
+    int  final_h = (out_height + pool_pad_bottom) / 2;
+    int  final_w = (out_width  + pool_pad_right)  / 2;
+
     /* ---- Accumulator register file (16 OC × 16 H × 16 W) ---- */
-    acc_t acc_buf[TILE_OC][TILE_H][TILE_W];
+    mac_t acc_buf[TILE_OC][TILE_H][TILE_W];
     #pragma HLS ARRAY_PARTITION variable=acc_buf dim=1 complete
     #pragma HLS ARRAY_PARTITION variable=acc_buf dim=3 complete
 
-    /* ---- Weight register file (256 × K×K) ---- */
-    data_t wt_buf[TILE_OC][TILE_IC][K_MAX][K_MAX];
+    /* ---- Weight register file, ping-pong (2 × 256 × K×K) ---- */
+    data_t wt_buf[2][TILE_OC][TILE_IC][K_MAX][K_MAX];
     #pragma HLS ARRAY_PARTITION variable=wt_buf dim=1 complete
     #pragma HLS ARRAY_PARTITION variable=wt_buf dim=2 complete
+    #pragma HLS ARRAY_PARTITION variable=wt_buf dim=3 complete
+
+    /* ---- Per-OC epilogue registers, ping-ponged with wt_buf ---- */
+    data_t     bias_buf[2][TILE_OC];
+    ap_int<16> scale_buf[2][TILE_OC];
+    #pragma HLS ARRAY_PARTITION variable=bias_buf complete dim=0
+    #pragma HLS ARRAY_PARTITION variable=scale_buf complete dim=0
+
+    /* ---- Window input: the stream carries the raw input window ---- */
+    bool win_in  = dw || (stride > 1);
+
+    int kk        = kernel_size * kernel_size;
+    int wt_beats  = WT_HDR_BEATS + (dw ? kk : TILE_OC * kk);  /* per block */
+    int n_blocks  = tr_steps * tc_steps * ti_steps * tpg_o;
+    int blk       = 0;                             /* block being computed   */
+    int cur       = 0;                             /* bank holding `blk`     */
+
+    /* -- Preamble: first weight block → bank 0 (only exposed load) -- */
+    PRE_HDR: for (int h = 0; h < WT_HDR_BEATS; h++) {
+        #pragma HLS PIPELINE II=1
+        vec_t hdr = weight_stream.read();
+        PRE_HDR_UNROLL: for (int oc = 0; oc < TILE_OC; oc++) {
+            #pragma HLS UNROLL
+            if (h == 0) bias_buf[0][oc].range(15, 0) = hdr.range(oc*16+15, oc*16);
+            else        scale_buf[0][oc]             = hdr.range(oc*16+15, oc*16);
+        }
+    }
+
+    PRE_WT_OC: for (int oc = 0; oc < (dw ? 1 : TILE_OC); oc++) {
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
+        PRE_WT_KY: for (int ky = 0; ky < kernel_size; ky++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
+            PRE_WT_KX: for (int kx = 0; kx < kernel_size; kx++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
+                #pragma HLS PIPELINE II=1
+                load_wt_beat(wt_buf, 0, weight_stream.read(), oc, ky, kx, dw);
+            }
+        }
+    }
 
     /* ---- Local input cache (filled once per IC tile, reused ×OC) ----
      * Eliminates redundant input_stream reads.  ~36 BRAM18K. */
     vec_t input_lcl[K_MAX][K_MAX][TILE_H][TILE_W];
     #pragma HLS BIND_STORAGE variable=input_lcl type=ram_2p impl=bram
 
-    /* ---- BN parameter registers ---- */
-    data_t scale_buf[TILE_OC];
-    data_t bias_buf[TILE_OC];
-    #pragma HLS ARRAY_PARTITION variable=scale_buf complete
-    #pragma HLS ARRAY_PARTITION variable=bias_buf complete
+    /* ---- Input window (depthwise, or any stride ≥ 2 layer): element
+     *      (r, c) in bank (r mod DW_BANKS, c mod DW_BANKS), so a pixel's
+     *      K×K taps are one read per bank.  9 × 11 × 11 beats,
+     *      ~18 BRAM18K. ---- */
+    vec_t dw_win[DW_BANKS][DW_BANKS][DW_WIN_H][DW_WIN_W];
+    #pragma HLS ARRAY_PARTITION variable=dw_win dim=1 complete
+    #pragma HLS ARRAY_PARTITION variable=dw_win dim=2 complete
+    #pragma HLS BIND_STORAGE variable=dw_win type=ram_2p impl=bram
 
     /* ---- Partial sum buffer for IC-outer accumulation ----
      * Stores intermediate partial sums across IC tiles.
@@ -351,48 +998,51 @@ void Execute_Layer(
         EXEC_COL: for (int tc = 0; tc < tc_steps; tc++) {
         #pragma HLS LOOP_TRIPCOUNT min=1 max=26 avg=8
 
-            int r_start = tr * TILE_H;
-            int c_start = tc * TILE_W;
+            int r_start = tr * step_h;
+            int c_start = tc * step_w;
             int curr_h = (r_start + TILE_H > out_height) ? out_height - r_start : TILE_H;
             int curr_w = (c_start + TILE_W > out_width)  ? out_width  - c_start : TILE_W;
+            int tile_in_h = (curr_h - 1) * stride + kernel_size;
+            int tile_in_w = (curr_w - 1) * stride + kernel_size;
 
             EXEC_IC: for (int ti = 0; ti < ti_steps; ti++) {
             #pragma HLS LOOP_TRIPCOUNT min=1 max=64 avg=16
-                bool is_first_ic = (ti == 0);
-                bool is_last_ic  = (ti == ti_steps - 1);
+                int  g    = ti / tpg_i;
+                int  ti_l = ti - g * tpg_i;
+                bool is_first_ic = (ti_l == 0);
+                bool is_last_ic  = (ti_l == tpg_i - 1);
 
                 /* -- Read input stream → local cache (ONCE per IC tile) -- */
-                LOAD_IN_KY: for (int ky = 0; ky < kernel_size; ky++) {
-                #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                    LOAD_IN_KX: for (int kx = 0; kx < kernel_size; kx++) {
+                if (win_in) {
+                    LOAD_WIN_R: for (int r = 0; r < tile_in_h; r++) {
+                    #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=18
+                        LOAD_WIN_C: for (int c = 0; c < tile_in_w; c++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=33 avg=18
+                            #pragma HLS PIPELINE II=1
+                            dw_win[r % DW_BANKS][c % DW_BANKS][r / DW_BANKS][c / DW_BANKS] =
+                                input_stream.read();
+                        }
+                    }
+                } else {
+                    LOAD_IN_KY: for (int ky = 0; ky < kernel_size; ky++) {
                     #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                        LOAD_IN_I: for (int i = 0; i < curr_h; i++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                            LOAD_IN_J: for (int j = 0; j < curr_w; j++) {
+                        LOAD_IN_KX: for (int kx = 0; kx < kernel_size; kx++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
+                            LOAD_IN_I: for (int i = 0; i < curr_h; i++) {
                             #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                                #pragma HLS PIPELINE II=1
-                                input_lcl[ky][kx][i][j] = input_stream.read();
+                                LOAD_IN_J: for (int j = 0; j < curr_w; j++) {
+                                #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
+                                    #pragma HLS PIPELINE II=1
+                                    input_lcl[ky][kx][i][j] = input_stream.read();
+                                }
                             }
                         }
                     }
                 }
 
-                EXEC_OC: for (int to = 0; to < to_steps; to++) {
+                EXEC_OC: for (int to = g * tpg_o; to < (g + 1) * tpg_o; to++) {
                 #pragma HLS LOOP_TRIPCOUNT min=1 max=64 avg=16
 
-                    /* -- Load BN params (only on last IC tile) -- */
-                    if (is_last_ic) {
-                        LOAD_BN: for (int idx = 0; idx < TILE_OC * 2; idx++) {
-                            #pragma HLS PIPELINE II=1
-                            #pragma HLS LOOP_TRIPCOUNT min=32 max=32 avg=32
-                            data_t val = bn_params[to * TILE_OC * 2 + idx];
-                            if (idx & 1)
-                                bias_buf[idx >> 1] = val;
-                            else
-                                scale_buf[idx >> 1] = val;
-                        }
-                    }
-
                     /* -- Initialize accumulator -- */
                     if (is_first_ic) {
                         /* Clear on first IC tile */
@@ -407,75 +1057,218 @@ void Execute_Layer(
                                 }
                             }
                         }
+                        PROF_CYCLES(curr_h * curr_w);
                     } else {
-                        /* Load partial sums from psum_buf (256 cycles) */
-                        LOAD_PSUM: for (int idx = 0; idx < TILE_OC * TILE_H; idx++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=256 max=256 avg=256
+                        /* Load partial sums from psum_buf (16 × curr_h cycles) */
+                        int oc = 0, i = 0;
+                        LOAD_PSUM: for (int idx = 0; idx < TILE_OC * curr_h; idx++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=16 max=256 avg=208
                             #pragma HLS PIPELINE II=1
-                            int oc = idx >> 4;   /* idx / 16 */
-                            int i  = idx & 0xF;  /* idx % 16 */
                             LOAD_PSUM_W: for (int j = 0; j < TILE_W; j++) {
                                 #pragma HLS UNROLL
-                                acc_buf[oc][i][j] = psum_buf[to][oc][i][j];
+                                acc_buf[oc][i][j] = acc_to_mac(psum_buf[to][oc][i][j]);
                             }
+                            if (i == curr_h - 1) { i = 0; oc++; } else { i++; }
                         }
+                        PROF_CYCLES(TILE_OC * curr_h);
                     }
 
-                    /* -- Read weight stream → register file -- */
-                    READ_WT_OC: for (int oc = 0; oc < TILE_OC; oc++) {
-                        READ_WT_KY: for (int ky = 0; ky < kernel_size; ky++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                            READ_WT_KX: for (int kx = 0; kx < kernel_size; kx++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                                #pragma HLS PIPELINE II=1
-                                vec_t w_pkg = weight_stream.read();
-                                RD_WT_UNROLL: for (int ic = 0; ic < TILE_IC; ic++) {
+                    /* -- 256-MAC compute (DSP-mapped) + next-block prefetch --
+                     * pf counts beats of block blk+1 already in bank nxt;
+                     * (pf_oc, pf_ky, pf_kx) is its write cursor. */
+                    int  nxt      = cur ^ 1;
+                    bool has_next = (blk + 1 < n_blocks);
+                    int  pf = 0, pf_oc = 0, pf_ky = 0, pf_kx = 0;
+
+                    /* -- Flattened pass: one pipeline over K² × pixels --
+                     * (ky, kx, i, j) is a row-wrapped cursor; q counts the
+                     * pixels of the current tap, bubbles past npix.
+                     * Depthwise: one sweep, all taps at once (ky = kx = 0,
+                     * no accumulator is revisited). */
+                    int npix   = curr_h * curr_w;
+                    int sweep  = (npix < ACC_RAW_DIST) ? ACC_RAW_DIST : npix;
+                    int n_iter = dw ? npix : kk * sweep;
+                    int ky = 0, kx = 0, i = 0, j = 0, q = 0;
+#ifndef __SYNTHESIS__
+                    /* C-sim check of the DEPENDENCE distance below: iteration
+                     * of each pixel's last acc_buf update */
+                    int acc_last[TILE_H][TILE_W];
+                    for (int y = 0; y < TILE_H; y++)
+                        for (int x = 0; x < TILE_W; x++) acc_last[y][x] = -ACC_RAW_DIST;
+                    assert(dw || sweep >= ACC_RAW_DIST);
+#endif
+
+                    COMPUTE_P: for (int p = 0; p < n_iter; p++) {
+                    #pragma HLS LOOP_TRIPCOUNT min=9 max=2304 avg=1521
+                        #pragma HLS PIPELINE II=1
+                        #pragma HLS DEPENDENCE variable=acc_buf inter distance=ACC_RAW_DIST true
+#if MAC_CASCADE
+                        #pragma HLS EXPRESSION_BALANCE off
+#endif
+
+                        /* Prefetch one beat of the next block */
+                        if (has_next && pf < WT_HDR_BEATS) {
+                            vec_t hdr = weight_stream.read();
+                            PF_HDR_UNROLL: for (int oc = 0; oc < TILE_OC; oc++) {
+                                #pragma HLS UNROLL
+                                if (pf == 0) bias_buf[nxt][oc].range(15, 0) = hdr.range(oc*16+15, oc*16);
+                                else         scale_buf[nxt][oc]             = hdr.range(oc*16+15, oc*16);
+                            }
+                            pf++;
+                        } else if (has_next && pf < wt_beats) {
+                            load_wt_beat(wt_buf, nxt, weight_stream.read(),
+                                         pf_oc, pf_ky, pf_kx, dw);
+                            pf++;
+                            if (pf_kx == kernel_size - 1) {
+                                pf_kx = 0;
+                                if (pf_ky == kernel_size - 1) { pf_ky = 0; pf_oc++; }
+                                else                          { pf_ky++; }
+                            } else {
+                                pf_kx++;
+                            }
+                        }
+
+                        /* Strided window: tap (ky, kx) of pixel (i, j) */
+                        int   wr     = i * stride + ky, wc = j * stride + kx;
+                        vec_t in_pkg = win_in
+                                     ? dw_win[wr % DW_BANKS][wc % DW_BANKS]
+                                             [wr / DW_BANKS][wc / DW_BANKS]
+                                     : input_lcl[ky][kx][i][j];
+                        bool  live   = (q < npix);
+
+                        /* Depthwise gather: bank (br, bc) holds exactly one
+                         * tap of the window at (r0, c0) — route it there */
+                        vec_t tap[K_MAX][K_MAX];
+                        #pragma HLS ARRAY_PARTITION variable=tap complete dim=0
+                        if (dw) {
+                            int r0 = i * stride, c0 = j * stride;
+                            int rm = r0 % DW_BANKS, cm = c0 % DW_BANKS;
+                            DW_GATHER_R: for (int br = 0; br < DW_BANKS; br++) {
+                                #pragma HLS UNROLL
+                                DW_GATHER_C: for (int bc = 0; bc < DW_BANKS; bc++) {
                                     #pragma HLS UNROLL
-                                    wt_buf[oc][ic][ky][kx].range(15, 0) =
-                                        w_pkg.range(ic*16+15, ic*16);
+                                    int ty = (br - rm + DW_BANKS) % DW_BANKS;
+                                    int tx = (bc - cm + DW_BANKS) % DW_BANKS;
+                                    tap[ty][tx] = dw_win[br][bc][(r0 + ty) / DW_BANKS]
+                                                                [(c0 + tx) / DW_BANKS];
                                 }
                             }
                         }
-                    }
-
-                    /* -- 256-MAC compute (DSP-mapped) -- */
-                    COMPUTE_KY: for (int ky = 0; ky < kernel_size; ky++) {
-                    #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                        COMPUTE_KX: for (int kx = 0; kx < kernel_size; kx++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=3 avg=3
-                            #pragma HLS LOOP_FLATTEN off
-
-                            COMPUTE_I: for (int i = 0; i < curr_h; i++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                                COMPUTE_J: for (int j = 0; j < curr_w; j++) {
-                                #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                                    #pragma HLS PIPELINE II=1
 
-                                    vec_t in_pkg = input_lcl[ky][kx][i][j];
+                        /* 16 OC × 16 IC = 256 MACs per cycle.  With
+                         * MAC_CASCADE the IC sum is a left-to-right chain
+                         * (no re-balancing into a tree) → PCIN/PCOUT. */
+                        MAC_OC: for (int oc = 0; oc < TILE_OC; oc++) {
+                            #pragma HLS UNROLL
+                            mac_t dot = 0;
+                            MAC_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                                #pragma HLS UNROLL
+                                data_t w_val = wt_buf[cur][oc][ic][ky][kx];
+                                data_t in_val;
+                                in_val.range(15, 0) =
+                                    in_pkg.range(ic*16+15, ic*16);
+                                if (dw) {
+                                    /* lane ic = tap (ic / K_MAX, ic % K_MAX)
+                                     * of channel oc; unused taps are zero */
+                                    const int ty = ic / K_MAX, tx = ic % K_MAX;
+                                    if (ic < K_MAX * K_MAX && ty < kernel_size && tx < kernel_size)
+                                        in_val.range(15, 0) = tap[ty][tx].range(oc*16+15, oc*16);
+                                    else
+                                        w_val = 0;
+                                }
+                                mac_t prod = mac_prod(w_val, in_val);
+                                #pragma HLS BIND_OP variable=prod op=mul impl=dsp
+                                dot += prod;
+                            }
+                            if (live) acc_buf[oc][i][j] += dot;
+                        }
+#ifndef __SYNTHESIS__
+                        if (live) {
+                            assert(p - acc_last[i][j] >= ACC_RAW_DIST);
+                            acc_last[i][j] = p;
+                        }
+#endif
+
+                        /* Advance the row-wrapped cursor: j → i → tap */
+                        if (q == sweep - 1) {
+                            q = 0; i = 0; j = 0;
+                            if (kx == kernel_size - 1) { kx = 0; ky++; }
+                            else                       { kx++; }
+                        } else {
+                            q++;
+                            if (j == curr_w - 1) { j = 0; i++; } else { j++; }
+                        }
+                    }
+                    PROF_CYCLES(PROF_MAC_DEPTH + n_iter - pf);
 
-                                    /* 16 OC × 16 IC = 256 MACs per cycle */
-                                    MAC_OC: for (int oc = 0; oc < TILE_OC; oc++) {
-                                        #pragma HLS UNROLL
-                                        acc_t dot = 0;
-                                        MAC_IC: for (int ic = 0; ic < TILE_IC; ic++) {
-                                            #pragma HLS UNROLL
-                                            data_t w_val = wt_buf[oc][ic][ky][kx];
-                                            data_t in_val;
-                                            in_val.range(15, 0) =
-                                                in_pkg.range(ic*16+15, ic*16);
-                                            acc_t prod = (acc_t)(w_val * in_val);
-                                            #pragma HLS BIND_OP variable=prod op=mul impl=dsp
-                                            dot += prod;
-                                        }
-                                        acc_buf[oc][i][j] += dot;
-                                    }
+                    /* -- Tail: finish the prefetch if the pass was shorter
+                     *    than one weight block (tiny edge tiles only) -- */
+                    if (has_next) {
+                        PF_WT_TAIL: for (int b = pf; b < wt_beats; b++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=0 max=146 avg=0
+                            #pragma HLS PIPELINE II=1
+                            vec_t w_pkg = weight_stream.read();
+                            if (b < WT_HDR_BEATS) {
+                                PF_TAIL_HDR: for (int oc = 0; oc < TILE_OC; oc++) {
+                                    #pragma HLS UNROLL
+                                    if (b == 0) bias_buf[nxt][oc].range(15, 0) = w_pkg.range(oc*16+15, oc*16);
+                                    else        scale_buf[nxt][oc]             = w_pkg.range(oc*16+15, oc*16);
                                 }
+                                continue;
+                            }
+                            load_wt_beat(wt_buf, nxt, w_pkg, pf_oc, pf_ky, pf_kx, dw);
+                            if (pf_kx == kernel_size - 1) {
+                                pf_kx = 0;
+                                if (pf_ky == kernel_size - 1) { pf_ky = 0; pf_oc++; }
+                                else                          { pf_ky++; }
+                            } else {
+                                pf_kx++;
                             }
                         }
                     }
+                    int done = cur;                /* bank of this block    */
+                    cur = nxt;
+                    blk++;
 
                     /* -- Post-process OR save partial sums -- */
-                    if (is_last_ic) {
+                    if (is_last_ic && pool2) {
+                        /* Last IC tile: 2×2 max + epilogue + Stream Out.
+                         * The epilogue is monotonic (positive scale), so the
+                         * max of the raw sums goes through it once instead of
+                         * four epilogues per lane.  Rows/cols past the conv
+                         * output are the zero pad, which joins the max after
+                         * activation. */
+                        int p_r0 = r_start >> 1;
+                        int p_c0 = c_start >> 1;
+                        int ph = (p_r0 + TILE_H / 2 > final_h) ? final_h - p_r0 : TILE_H / 2;
+                        int pw = (p_c0 + TILE_W / 2 > final_w) ? final_w - p_c0 : TILE_W / 2;
+                        STREAM_POOL_H: for (int pi = 0; pi < ph; pi++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=1 max=8 avg=8
+                            STREAM_POOL_W: for (int pj = 0; pj < pw; pj++) {
+                            #pragma HLS LOOP_TRIPCOUNT min=1 max=8 avg=8
+                                #pragma HLS PIPELINE II=1
+                                int  y0 = pi * 2, x0 = pj * 2;
+                                bool y1_ok = (y0 + 1 < curr_h);
+                                bool x1_ok = (x0 + 1 < curr_w);
+                                vec_t out_pkg;
+                                OUT_POOL_OC: for (int oc = 0; oc < TILE_OC; oc++) {
+                                    #pragma HLS UNROLL
+                                    mac_t a0 = acc_buf[oc][y0][x0];
+                                    mac_t a1 = y1_ok ? acc_buf[oc][y0 + 1][x0] : a0;
+                                    mac_t a2 = x1_ok ? acc_buf[oc][y0][x0 + 1] : a0;
+                                    mac_t a3 = (y1_ok && x1_ok) ? acc_buf[oc][y0 + 1][x0 + 1] : a0;
+                                    mac_t mx01 = (a0 > a1) ? a0 : a1;
+                                    mac_t mx23 = (a2 > a3) ? a2 : a3;
+                                    data_t res = epilogue((mx01 > mx23) ? mx01 : mx23,
+                                                          scale_buf[done][oc], bias_buf[done][oc],
+                                                          use_leaky);
+                                    if (!(y1_ok && x1_ok) && res < (data_t)0) res = 0;
+                                    out_pkg.range(oc*16+15, oc*16) = res.range(15, 0);
+                                }
+                                output_stream.write(out_pkg);
+                            }
+                        }
+                    } else if (is_last_ic) {
                         /* Last IC tile: BN + Activate + Stream Out */
                         STREAM_OUT_H: for (int i = 0; i < curr_h; i++) {
                         #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
@@ -485,28 +1278,26 @@ void Execute_Layer(
                                 vec_t out_pkg;
                                 OUT_PACK_OC: for (int oc = 0; oc < TILE_OC; oc++) {
                                     #pragma HLS UNROLL
-                                    acc_t bn_mul = acc_buf[oc][i][j] * scale_buf[oc];
-                                    #pragma HLS BIND_OP variable=bn_mul op=mul impl=dsp
-                                    data_t res = activate(
-                                        (data_t)(bn_mul + bias_buf[oc]),
-                                        use_leaky);
+                                    data_t res = epilogue(acc_buf[oc][i][j], scale_buf[done][oc],
+                                                          bias_buf[done][oc], use_leaky);
                                     out_pkg.range(oc*16+15, oc*16) = res.range(15, 0);
                                 }
                                 output_stream.write(out_pkg);
                             }
                         }
                     } else {
-                        /* Save partial sums to psum_buf (256 cycles) */
-                        SAVE_PSUM: for (int idx = 0; idx < TILE_OC * TILE_H; idx++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=256 max=256 avg=256
+                        /* Save partial sums to psum_buf (16 × curr_h cycles) */
+                        int oc = 0, i = 0;
+                        SAVE_PSUM: for (int idx = 0; idx < TILE_OC * curr_h; idx++) {
+                        #pragma HLS LOOP_TRIPCOUNT min=16 max=256 avg=208
                             #pragma HLS PIPELINE II=1
-                            int oc = idx >> 4;   /* idx / 16 */
-                            int i  = idx & 0xF;  /* idx % 16 */
                             SAVE_PSUM_W: for (int j = 0; j < TILE_W; j++) {
                                 #pragma HLS UNROLL
-                                psum_buf[to][oc][i][j] = acc_buf[oc][i][j];
+                                psum_buf[to][oc][i][j] = mac_to_acc(acc_buf[oc][i][j]);
                             }
+                            if (i == curr_h - 1) { i = 0; oc++; } else { i++; }
                         }
+                        PROF_CYCLES(TILE_OC * curr_h);
                     }
 
                 } /* EXEC_OC */
@@ -526,51 +1317,128 @@ void Execute_Layer(
  *
  * V3 approach (Verilog FSM-style):
  *   Phase 1: READ stream → tile_buf (on-chip)
- *   Phase 2: For each output row of each OC channel:
- *     2a. READ edge words from DRAM → dma_out[] (1-2 scalar reads)
- *     2b. PACK tile data into dma_out[] (pure register ops, no DRAM)
- *     2c. BURST WRITE dma_out[] → DRAM (clean sequential burst)
+ *   Phase 2, flattened over every (OC, row) of the tile:
+ *     2a. READ partial edge words from DRAM → edge_hd/edge_tl[]
+ *     2b. PACK a whole row per cycle (16-lane barrel shift into a
+ *         two-word line) and WRITE one 256-bit word per cycle
+ *
+ * This separation guarantees burst inference for the write phase, and
+ * the full-row pack lets Write drain a tile (16 OC × 16 rows ≤ 512 beats)
+ * about as fast as Execute's epilogue produces it.
+ *
+ * 2×2 / stride-2 pooling is done in Execute's epilogue: those tiles arrive
+ * already pooled (≤ 8×8 per tile) and take the direct path into the
+ * pooled map.  2×2 / stride-1 pooling runs here on tile_buf.
+ * pool_pad_bottom/right append zero rows/columns first (nn.ZeroPad2d
+ * semantics).  For stride 1 the tile grid steps by TILE-1 (tile_ovl=1), so
+ * every pool window of a tile lies inside it; only the image's
+ * bottom/right edge reads padding.
+ *
+ * With use_chan_map=1, compacted OC o lands in DRAM plane oc_plane[o].
+ * oc_offset shifts every plane, so a layer can write its channel slice of
+ * a larger concat (route) tensor in place — in CHW a slice is a run of
+ * whole planes, so the offset is the only address change.
  *
- * This separation guarantees burst inference for the write phase.
+ * ACT8 output (out_act_shift ≥ 0): the pack step rounds each value to an
+ * int8 byte (insert_act) and the address decode switches to 32 per word,
+ * so every output row costs half the write beats.
+ *
+ * use_upsample=1 writes a 2× nearest-neighbour upsampled map: each value
+ * lands in a 2×2 block of a (2·final_h)×(2·final_w) plane.  use_add=1
+ * adds a second tensor, read from residual_dram in the output map's own
+ * layout and format, to every value before it is packed (saturating,
+ * after activation/pool/upsample — a YOLOv3 shortcut).  Both happen on
+ * the way to DRAM, so these layers need no PS round trip.
+ *
+ * Every packed value also feeds the layer's activation statistics (min,
+ * max, clip count, log2 histogram — STAT_* in conv_engine.h): each beat
+ * reduces its slots, the layer totals live in registers, and the
+ * STAT_WORDS block is written to stats_dram after the last tile.  The
+ * host reads back the range of every map without dumping it.
  *
  *  ┌────────────┐     ┌───────────┐     ┌──────────┐
- *  │ tile_buf   │────→│ dma_out[] │────→│  DRAM    │
- *  │ [16][16][16│     │ staging   │     │ (m_axi)  │
- *  └────────────┘     └───────────┘     └──────────┘
- *  BRAM (on-chip)     Pack buffer       AXI burst write
+ *  │ tile_buf   │────→│ row_v[32] │────→│  DRAM    │
+ *  │ [16][16][16│ 16  │ barrel    │  ↑  │ (m_axi)  │
+ *  └────────────┘lanes└───────────┘  │  └──────────┘
+ *  BRAM (on-chip)     Pack register  + res_buf word (use_add)
  *
  * ========================================================================= */
 void Write_Layer(
     wide_t* output_dram,
-    hls::stream<vec_t>& output_stream,
+    wide_t* residual_dram,
+    int*    oc_map_dram,
+    int*    stats_dram,
+    vec_stream_t& output_stream,
     int out_channels, int out_height, int out_width,
-    int use_pool,     int pool_stride
+    int grid_h,       int grid_w,     int tile_ovl,
+    int use_pool,     int pool_stride,
+    int pool_pad_bottom, int pool_pad_right,
+    int use_chan_map, int out_act_shift,
+    int use_upsample, int use_add,
+    int oc_offset
 ) {
-    int tr_steps = (out_height + TILE_H - 1) / TILE_H;
-    int tc_steps = (out_width  + TILE_W - 1) / TILE_W;
+    PROF_STAGE("Write_Layer");
+    int step_h   = TILE_H - tile_ovl;
+    int step_w   = TILE_W - tile_ovl;
+    int tr_steps = (grid_h + step_h - 1) / step_h;
+    int tc_steps = (grid_w + step_w - 1) / step_w;
     int to_steps = (out_channels + TILE_OC - 1) / TILE_OC;
 
+    /* ---- Element → word decode: 16 (data_t) or 32 (ACT8) per word ---- */
+    int es = (out_act_shift >= 0) ? 5 : 4;
+    int em = (1 << es) - 1;
+
+    /* ---- Channel remap: compacted OC → DRAM plane (identity if off),
+     *      offset into the destination tensor's channel slice ---- */
+    int oc_plane[MAX_CHANNELS];
+    LOAD_OC_MAP: for (int o = 0; o < out_channels; o++) {
+    #pragma HLS LOOP_TRIPCOUNT min=16 max=1024 avg=256
+        #pragma HLS PIPELINE II=1
+        oc_plane[o] = oc_offset + (use_chan_map ? oc_map_dram[o] : o);
+    }
+    PROF_CYCLES((use_chan_map ? PROF_AXI_LATENCY : 0) + out_channels);
+
     /* ---- Tile buffer BRAM ---- */
     data_t tile_buf[TILE_OC][TILE_H][TILE_W];
     #pragma HLS ARRAY_PARTITION variable=tile_buf dim=1 complete
     #pragma HLS ARRAY_PARTITION variable=tile_buf dim=3 complete
 
-    /* ---- DMA write staging buffer (Verilog: AXI write channel FIFO) ---- */
-    wide_t dma_out[DMA_OUT_WORDS];
+    /* ---- Edge words of one tile's rows (read-modify-write heads/tails) ---- */
+    wide_t edge_hd[TILE_OC * TILE_H * 2];
+    wide_t edge_tl[TILE_OC * TILE_H * 2];
 
-    /* ---- Pooling scratch buffer ---- */
-    data_t pool_row[TILE_W / 2];
-    #pragma HLS ARRAY_PARTITION variable=pool_row complete
+    /* ---- Residual words of one tile (use_add), in write-beat order: up to
+     *      TILE_OC·TILE_H·2 rows of ≤ 3 words ---- */
+    wide_t res_buf[TILE_OC * TILE_H * 2 * 3];
 
-    /* Compute final DRAM dimensions */
+    /* Compute final DRAM dimensions (2×2 window over the padded map) */
     int final_h, final_w;
     if (use_pool && pool_stride >= 2) {
-        final_h = out_height / pool_stride;
-        final_w = out_width  / pool_stride;
+        final_h = (out_height + pool_pad_bottom) / 2;
+        final_w = (out_width  + pool_pad_right)  / 2;
+    } else if (use_pool) {
+        final_h = out_height + pool_pad_bottom - 1;
+        final_w = out_width  + pool_pad_right  - 1;
     } else {
         final_h = out_height;
         final_w = out_width;
     }
+    bool pool2 = use_pool && (pool_stride >= 2);   /* pooled by Execute */
+    bool pool1 = use_pool && !pool2;              /* pooled here       */
+
+    /* DRAM plane dimensions after the optional 2× upsample */
+    int up    = use_upsample ? 2 : 1;
+    int map_h = final_h * up;
+    int map_w = final_w * up;
+
+    /* ---- Activation statistics accumulators (raw data_t units) ---- */
+    int st_min = 32767, st_max = -32768, st_sat = 0, st_cnt = 0;
+    int st_hist[STAT_BINS];
+    #pragma HLS ARRAY_PARTITION variable=st_hist complete
+    STAT_INIT: for (int k = 0; k < STAT_BINS; k++) {
+        #pragma HLS UNROLL
+        st_hist[k] = 0;
+    }
 
     WB_ROW: for (int tr = 0; tr < tr_steps; tr++) {
     #pragma HLS LOOP_TRIPCOUNT min=1 max=26 avg=8
@@ -579,18 +1447,27 @@ void Write_Layer(
             WB_OC: for (int to = 0; to < to_steps; to++) {
             #pragma HLS LOOP_TRIPCOUNT min=1 max=64 avg=16
 
-                int r_start = tr * TILE_H;
-                int c_start = tc * TILE_W;
+                int r_start = tr * step_h;
+                int c_start = tc * step_w;
                 int curr_h  = (r_start + TILE_H > out_height) ? out_height - r_start : TILE_H;
                 int curr_w  = (c_start + TILE_W > out_width)  ? out_width  - c_start : TILE_W;
                 int oc_limit = (to * TILE_OC + TILE_OC > out_channels)
                              ? (out_channels - to * TILE_OC) : TILE_OC;
 
+                /* Block this tile delivers: pre-pooled (pool2) or as-is */
+                int blk_r0 = pool2 ? r_start >> 1 : r_start;
+                int blk_c0 = pool2 ? c_start >> 1 : c_start;
+                int blk_h  = curr_h, blk_w = curr_w;
+                if (pool2) {
+                    blk_h = (blk_r0 + TILE_H / 2 > final_h) ? final_h - blk_r0 : TILE_H / 2;
+                    blk_w = (blk_c0 + TILE_W / 2 > final_w) ? final_w - blk_c0 : TILE_W / 2;
+                }
+
                 /* ====== Phase 1: Read output stream → tile_buf ======
                  * Verilog: deserialize stream into BRAM */
-                RD_STREAM_H: for (int i = 0; i < curr_h; i++) {
+                RD_STREAM_H: for (int i = 0; i < blk_h; i++) {
                 #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                    RD_STREAM_W: for (int j = 0; j < curr_w; j++) {
+                    RD_STREAM_W: for (int j = 0; j < blk_w; j++) {
                     #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
                         #pragma HLS PIPELINE II=1
                         vec_t out_pkg = output_stream.read();
@@ -603,181 +1480,833 @@ void Write_Layer(
                 }
 
                 /* ====== Phase 2: DMA write to DRAM ======
-                 * For each OC channel, for each row, pack + burst-write. */
-
-                if (use_pool && pool_stride >= 2) {
-                    /* ---- Pooled write path ---- */
-                    int ph = curr_h / pool_stride;
-                    int pw = curr_w / pool_stride;
-
-                    POOL_WR_OC: for (int oc = 0; oc < TILE_OC; oc++) {
-                        if (oc >= oc_limit) continue;
-                        int global_oc = to * TILE_OC + oc;
-
-                        POOL_WR_ROW: for (int pi = 0; pi < ph; pi++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=8 avg=4
-
-                            /* -- Step 2a: Compute pooled values into scratch -- */
-                            POOL_CALC: for (int pj = 0; pj < pw; pj++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=8 avg=4
-                                #pragma HLS PIPELINE II=1
-                                data_t v0 = tile_buf[oc][pi*2  ][pj*2  ];
-                                data_t v1 = tile_buf[oc][pi*2+1][pj*2  ];
-                                data_t v2 = tile_buf[oc][pi*2  ][pj*2+1];
-                                data_t v3 = tile_buf[oc][pi*2+1][pj*2+1];
-                                data_t mx01 = (v0 > v1) ? v0 : v1;
+                 * Every (oc, row) of the tile is one output row segment of
+                 * wr_w ≤ 16 elements — or, upsampled, two rows of 2·wr_w
+                 * ≤ 32 — i.e. one to three DRAM words.  The rows of all OC
+                 * planes run back-to-back through two flattened loops, so
+                 * each AXI latency is paid once per tile. */
+                int wr_h   = pool1 ? ((blk_r0 + step_h > final_h) ? final_h - blk_r0 : step_h) : blk_h;
+                int wr_w   = pool1 ? ((blk_c0 + step_w > final_w) ? final_w - blk_c0 : step_w) : blk_w;
+                int seg_w  = wr_w * up;
+                int seg_c0 = blk_c0 * up;
+                int n_rows = oc_limit * wr_h * up;
+
+                /* -- Step 2a: Read edge words (Verilog: AXI read) --
+                 * Only partial words need read-modify-write; when the block
+                 * and the map are word-aligned there are none and the loop
+                 * is skipped.  All reads of the tile are issued before its
+                 * first write. */
+                bool aligned = ((seg_c0 | seg_w | map_w) & em) == 0;
+                int  n_beats = 0, n_rd = 0;
+                int  e_oc = 0, e_i = 0, e_d = 0;
+                EDGE_RD: for (int r = 0; r < n_rows; r++) {
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=512 avg=128
+                    #pragma HLS PIPELINE II=1
+                    int base_idx   = (oc_plane[to * TILE_OC + e_oc] * map_h
+                                   + (blk_r0 + e_i) * up + e_d) * map_w + seg_c0;
+                    int end_idx    = base_idx + seg_w - 1;
+                    int n_words    = (end_idx >> es) - (base_idx >> es) + 1;
+                    bool head_part = (base_idx & em) != 0;
+                    bool tail_part = (end_idx & em) != em;
+                    n_beats += n_words;
+                    if (!aligned) {
+                        if (head_part || (n_words == 1 && tail_part)) {
+                            edge_hd[r] = output_dram[base_idx >> es];
+                            n_rd++;
+                        }
+                        if (n_words > 1 && tail_part) {
+                            edge_tl[r] = output_dram[end_idx >> es];
+                            n_rd++;
+                        }
+                    }
+                    if (++e_d == up) {
+                        e_d = 0;
+                        if (++e_i == wr_h) { e_i = 0; e_oc++; }
+                    }
+                }
+                PROF_CYCLES(aligned ? 0 : (n_rd ? PROF_AXI_LATENCY : 0) + (n_rd > n_rows ? n_rd : n_rows));
+
+                /* -- Step 2a': Read residual words (use_add) --
+                 * The words the tile will write are burst from residual_dram
+                 * into res_buf in beat order, before the first write, so the
+                 * II=1 write loop issues no reads on gmem1 and its writes
+                 * still burst. */
+                int r_first = 0, r_nw = 1, r_w = 0, r_oc = 0, r_i = 0, r_d = 0;
+                RES_RD: for (int b = 0; b < (use_add ? n_beats : 0); b++) {
+                #pragma HLS LOOP_TRIPCOUNT min=0 max=1536 avg=256
+                    #pragma HLS PIPELINE II=1
+                    if (r_w == 0) {
+                        int r_base = (oc_plane[to * TILE_OC + r_oc] * map_h
+                                   + (blk_r0 + r_i) * up + r_d) * map_w + seg_c0;
+                        r_first = r_base >> es;
+                        r_nw    = ((r_base + seg_w - 1) >> es) - r_first + 1;
+                    }
+                    res_buf[b] = residual_dram[r_first + r_w];
+                    if (++r_w == r_nw) {
+                        r_w = 0;
+                        if (++r_d == up) {
+                            r_d = 0;
+                            if (++r_i == wr_h) { r_i = 0; r_oc++; }
+                        }
+                    }
+                }
+                PROF_CYCLES(use_add ? PROF_AXI_LATENCY + n_beats : 0);
+
+                /* -- Step 2b: Pack + write, one 256-bit word per cycle --
+                 * At the first beat of a row the 16 tile_buf lanes are
+                 * pooled (if pool1) and, for upsample, each lane fans out
+                 * to two slots of row_v.  Every beat then fills its word's
+                 * slots straight from row_v (a barrel shift, no serial slot
+                 * loop), adding the matching slot of the residual word
+                 * buffered in step 2a' first when use_add.  A word shared with the previous row
+                 * (narrow maps, ACT8) is forwarded from the word just
+                 * written, since its DRAM copy was read before that write
+                 * landed.  Rows are visited in ascending address order
+                 * (oc_map must be ascending), so only the previous row can
+                 * share a word.
+                 * Verilog: AXI AWLEN=0..2 per row, WVALID high every cycle */
+                data_t row_v[2 * TILE_W];
+                #pragma HLS ARRAY_PARTITION variable=row_v complete
+                int w_oc = 0, w_i = 0, w_d = 0, w_w = 0, w_r = 0;
+                int base_idx = 0, first_word = 0, n_words = 1, prev_word = -1;
+                bool head_rd = false, tail_rd = false;
+                wide_t prev_val = 0;
+                WR_BEAT: for (int b = 0; b < n_beats; b++) {
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=1024 avg=256
+                    #pragma HLS PIPELINE II=1
+                    if (w_w == 0) {
+                        base_idx = (oc_plane[to * TILE_OC + w_oc] * map_h
+                                 + (blk_r0 + w_i) * up + w_d) * map_w + seg_c0;
+                        int end_idx = base_idx + seg_w - 1;
+                        first_word  = base_idx >> es;
+                        n_words     = (end_idx >> es) - first_word + 1;
+                        bool tail_part = (end_idx & em) != em;
+                        head_rd = !aligned && ((base_idx & em) != 0 || (n_words == 1 && tail_part));
+                        tail_rd = !aligned && n_words > 1 && tail_part;
+
+                        PACK_LANE: for (int j = 0; j < TILE_W; j++) {
+                            #pragma HLS UNROLL
+                            data_t v = tile_buf[w_oc][w_i][j];
+                            if (pool1 && j < wr_w) {
+                                /* Rows/cols past the conv output are the zero pad */
+                                bool y1_ok = (w_i + 1 < curr_h);
+                                bool x1_ok = (j + 1 < curr_w);
+                                data_t v1 = y1_ok ? tile_buf[w_oc][w_i + 1][j] : (data_t)0;
+                                data_t v2 = x1_ok ? tile_buf[w_oc][w_i][j + 1] : (data_t)0;
+                                data_t v3 = (y1_ok && x1_ok)
+                                          ? tile_buf[w_oc][w_i + 1][j + 1] : (data_t)0;
+                                data_t mx01 = (v > v1) ? v : v1;
                                 data_t mx23 = (v2 > v3) ? v2 : v3;
-                                pool_row[pj] = (mx01 > mx23) ? mx01 : mx23;
-                            }
-
-                            /* -- Step 2b: Address decode for this output row -- */
-                            int out_r = (r_start / pool_stride) + pi;
-                            int out_c = c_start / pool_stride;
-                            int base_idx = (global_oc * final_h + out_r) * final_w + out_c;
-                            int first_word = base_idx >> 4;
-                            int start_slot = base_idx & 0xF;
-                            int end_idx    = base_idx + pw - 1;
-                            int last_word  = end_idx >> 4;
-                            int n_words    = last_word - first_word + 1;
-
-                            /* -- Step 2c: Read edge words (Verilog: AXI read) --
-                             * Only read the first/last word if they're partial.
-                             * This is the ONLY place we read from output DRAM. */
-                            EDGE_RD_POOL: for (int w = 0; w < n_words; w++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=2 avg=1
-                                #pragma HLS PIPELINE II=1
-                                if ((w == 0 && start_slot != 0) ||
-                                    (w == n_words - 1 && (end_idx & 0xF) != 15)) {
-                                    dma_out[w] = output_dram[first_word + w];
-                                } else {
-                                    dma_out[w] = (wide_t)0;
-                                }
-                            }
-
-                            /* -- Step 2d: Pack pooled values into staging buffer --
-                             * Pure on-chip: pool_row → dma_out words
-                             * Verilog: MUX + bit-insert logic */
-                            PACK_POOL: for (int pj = 0; pj < pw; pj++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=8 avg=4
-                                #pragma HLS PIPELINE II=1
-                                int flat = base_idx + pj;
-                                int wi   = (flat >> 4) - first_word;
-                                int si   =  flat & 0xF;
-                                insert_elem(dma_out[wi], si, pool_row[pj]);
-                            }
-
-                            /* -- Step 2e: Burst write staging → DRAM --
-                             * Clean sequential loop. No conditionals.
-                             * Verilog: AXI AWLEN=n_words-1, AWBURST=INCR */
-                            BURST_WR_POOL: for (int w = 0; w < n_words; w++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=2 avg=1
-                                #pragma HLS PIPELINE II=1
-                                output_dram[first_word + w] = dma_out[w];
+                                v = (mx01 > mx23) ? mx01 : mx23;
                             }
+                            if (up == 2) { row_v[2 * j] = v; row_v[2 * j + 1] = v; }
+                            else         { row_v[j] = v; }
                         }
                     }
 
-                } else {
-                    /* ---- Direct write path (no pooling) ---- */
-                    DIRECT_WR_OC: for (int oc = 0; oc < TILE_OC; oc++) {
-                        if (oc >= oc_limit) continue;
-                        int global_oc = to * TILE_OC + oc;
-
-                        DIRECT_WR_ROW: for (int i = 0; i < curr_h; i++) {
-                        #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-
-                            /* -- Step 2b: Address decode for this output row -- */
-                            int base_idx   = (global_oc * out_height + r_start + i) * out_width + c_start;
-                            int first_word = base_idx >> 4;
-                            int start_slot = base_idx & 0xF;
-                            int end_idx    = base_idx + curr_w - 1;
-                            int last_word  = end_idx >> 4;
-                            int n_words    = last_word - first_word + 1;
-
-                            /* -- Step 2c: Read edge words (Verilog: AXI read) --
-                             * Only partial words need read-modify-write.
-                             * Full words are overwritten completely. */
-                            EDGE_RD_DIRECT: for (int w = 0; w < n_words; w++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=2 avg=1
-                                #pragma HLS PIPELINE II=1
-                                if ((w == 0 && start_slot != 0) ||
-                                    (w == n_words - 1 && (end_idx & 0xF) != 15)) {
-                                    dma_out[w] = output_dram[first_word + w];
-                                } else {
-                                    dma_out[w] = (wide_t)0;
-                                }
-                            }
-
-                            /* -- Step 2d: Pack tile data into staging buffer --
-                             * Pure on-chip: tile_buf → dma_out words
-                             * Verilog: data path packing logic */
-                            PACK_DIRECT: for (int j = 0; j < curr_w; j++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=16
-                                #pragma HLS PIPELINE II=1
-                                int flat = base_idx + j;
-                                int wi   = (flat >> 4) - first_word;
-                                int si   =  flat & 0xF;
-                                insert_elem(dma_out[wi], si, tile_buf[oc][i][j]);
-                            }
+                    int    wd   = first_word + w_w;
+                    wide_t word = (w_w == 0 && wd == prev_word) ? prev_val
+                                : (w_w == 0 && head_rd) ? edge_hd[w_r]
+                                : (w_w == n_words - 1 && tail_rd) ? edge_tl[w_r]
+                                : (wide_t)0;
+                    wide_t res  = use_add ? res_buf[b] : (wide_t)0;
+                    int    e0   = (wd << es) - base_idx;  /* row element in slot 0 */
+                    int    b_min = 32767, b_max = -32768, b_sat = 0, b_cnt = 0;
+                    int    b_hist[STAT_BINS];
+                    #pragma HLS ARRAY_PARTITION variable=b_hist complete
+                    BEAT_HIST_INIT: for (int k = 0; k < STAT_BINS; k++) {
+                        #pragma HLS UNROLL
+                        b_hist[k] = 0;
+                    }
+                    PACK_SLOT: for (int s = 0; s < ACT8_PER_WORD; s++) {
+                        #pragma HLS UNROLL
+                        int e = e0 + s;
+                        if (s <= em && e >= 0 && e < seg_w) {
+                            data_t v = row_v[e];
+                            if (use_add) v = (data_t)(v + extract_act(res, s, out_act_shift));
+                            insert_act(word, s, v, out_act_shift);
+
+                            int raw = (ap_int<16>)v.range(15, 0);
+                            if (raw < b_min) b_min = raw;
+                            if (raw > b_max) b_max = raw;
+                            if (act_clipped(v, out_act_shift)) b_sat++;
+                            b_cnt++;
+                            b_hist[act_bin(v)]++;
+                        }
+                    }
+                    output_dram[wd] = word;
+
+                    /* Beat totals → layer totals */
+                    if (b_min < st_min) st_min = b_min;
+                    if (b_max > st_max) st_max = b_max;
+                    st_sat += b_sat;
+                    st_cnt += b_cnt;
+                    STAT_ACC: for (int k = 0; k < STAT_BINS; k++) {
+                        #pragma HLS UNROLL
+                        st_hist[k] += b_hist[k];
+                    }
 
-                            /* -- Step 2e: Burst write staging → DRAM --
-                             * Clean sequential loop. No conditionals.
-                             * Verilog: AXI AWLEN=n_words-1, AWBURST=INCR, WVALID toggling */
-                            BURST_WR_DIRECT: for (int w = 0; w < n_words; w++) {
-                            #pragma HLS LOOP_TRIPCOUNT min=1 max=2 avg=1
-                                #pragma HLS PIPELINE II=1
-                                output_dram[first_word + w] = dma_out[w];
-                            }
+                    if (++w_w == n_words) {
+                        prev_word = wd;
+                        prev_val  = word;
+                        w_w = 0;
+                        w_r++;
+                        if (++w_d == up) {
+                            w_d = 0;
+                            if (++w_i == wr_h) { w_i = 0; w_oc++; }
                         }
                     }
                 }
+                PROF_CYCLES(n_beats);
 
             } /* WB_OC */
         }
     }
+
+    /* ====== Activation statistics → stats_dram (one short burst) ====== */
+    STAT_WR: for (int k = 0; k < STAT_WORDS; k++) {
+        #pragma HLS PIPELINE II=1
+        int w = (k == STAT_MIN)   ? st_min
+              : (k == STAT_MAX)   ? st_max
+              : (k == STAT_SAT)   ? st_sat
+              : (k == STAT_COUNT) ? st_cnt
+              : st_hist[(k - STAT_HIST) & (STAT_BINS - 1)];
+        stats_dram[k] = w;
+    }
+    PROF_CYCLES(STAT_WORDS);
 }
 
 /* =========================================================================
  * DATAFLOW CORE
  *
- * Verilog analogy: top-level structural connection of three pipeline stages
+ * Verilog analogy: top-level structural connection of four pipeline stages
  * connected by FIFO channels.
  *
- *  Fetch ──[input_stream]──→ Execute ──[output_stream]──→ Write
- *       └──[weight_stream]──┘
+ *  Fetch_Layer   ──[input_stream]──→ Execute ──[output_stream]──→ Write
+ *  Fetch_Weights ──[weight_stream]──┘
  * ========================================================================= */
 static void conv_dataflow(
     wide_t* input_dram,
     wide_t* output_dram,
     wide_t* weights_dram,
-    data_t* bn_params_dram,
+    wide_t* residual_dram,
+    int*    ic_map_dram,
+    int*    oc_map_dram,
+    int*    stats_dram,
+    wide_t* next_weights_dram,
     int in_channels, int out_channels,
     int in_height,   int in_width,
-    int kernel_size,  int stride, int padding,
-    int use_pool,     int pool_stride, int use_leaky,
-    int out_height,   int out_width
+    int kernel_size,  int stride,
+    int pad_top,      int pad_left, int pad_right,
+    int use_pool,     int pool_stride,
+    int pool_pad_bottom, int pool_pad_right,
+    int use_leaky,    int use_chan_map, int wt_int8,
+    int in_act_shift, int out_act_shift,
+    int use_upsample, int use_add,     int oc_offset,
+    int in_ic_offset, int row_pitch,   int plane_pitch, int view_origin,
+    int groups,
+    int next_wt_blocks, int next_wt_blk_words, int next_wt_stride,
+    int wt_staged,
+    int out_height,   int out_width,
+    int grid_h,       int grid_w,   int tile_ovl
 ) {
     #pragma HLS DATAFLOW
 
     /* ---- Stream FIFOs (Verilog: hls::stream = FIFO primitive) ---- */
-    hls::stream<vec_t> input_stream("input_stream");
-    hls::stream<vec_t> weight_stream("weight_stream");
-    hls::stream<vec_t> output_stream("output_stream");
+    vec_stream_t input_stream("input_stream");
+    vec_stream_t weight_stream("weight_stream");
+    vec_stream_t output_stream("output_stream");
+
+    #pragma HLS STREAM variable=input_stream  depth=INPUT_STREAM_DEPTH
+    #pragma HLS STREAM variable=weight_stream depth=WEIGHT_STREAM_DEPTH
+    #pragma HLS STREAM variable=output_stream depth=OUTPUT_STREAM_DEPTH
+
+    Fetch_Layer(input_dram, ic_map_dram, input_stream,
+                in_channels, in_height, in_width,
+                kernel_size, stride, pad_top, pad_left, pad_right,
+                out_height, out_width, grid_h, grid_w, tile_ovl,
+                use_chan_map, in_act_shift,
+                in_ic_offset, row_pitch, plane_pitch, view_origin,
+                (groups > 1) && (groups == in_channels));
+
+    Fetch_Weights(weights_dram, next_weights_dram, weight_stream,
+                  in_channels, out_channels, kernel_size,
+                  grid_h, grid_w, tile_ovl, wt_int8, groups,
+                  next_wt_blocks, next_wt_blk_words, next_wt_stride,
+                  wt_staged);
+
+    Execute_Layer(input_stream, weight_stream, output_stream,
+                  in_channels, out_channels, out_height, out_width,
+                  grid_h, grid_w, tile_ovl, kernel_size, use_leaky,
+                  use_pool, pool_stride, pool_pad_bottom, pool_pad_right,
+                  stride, groups);
+
+    Write_Layer(output_dram, residual_dram, oc_map_dram, stats_dram, output_stream,
+                out_channels, out_height, out_width,
+                grid_h, grid_w, tile_ovl, use_pool, pool_stride,
+                pool_pad_bottom, pool_pad_right, use_chan_map, out_act_shift,
+                use_upsample, use_add, oc_offset);
+}
 
-    #pragma HLS STREAM variable=input_stream  depth=8192
-    #pragma HLS STREAM variable=weight_stream depth=4096
-    #pragma HLS STREAM variable=output_stream depth=4096
+/* =========================================================================
+ * FUSED EARLY-LAYER PIPELINE (fuse_early=1)
+ *
+ * conv1→pool→conv2→pool→conv3→pool as ONE invocation.  Each layer is a
+ * Fuse_ConvPool<CIN, COUT> process with its own 3-row line buffer, weight
+ * store and 16 OC × 16 IC MAC array; stages pass pooled rows to each other
+ * through FIFOs, so the 16×208×208 and 32×104×104 maps never reach DRAM.
+ *
+ *  Fuse_Read ──→ Conv1+Pool ──→ Conv2+Pool ──→ Conv3+Pool ──→ Fuse_Write
+ *                    ↑ prm1         ↑ prm2         ↑ prm3
+ *  Fuse_Params ──────┴──────────────┴──────────────┘
+ *
+ * A pixel with C channels travels as ceil(C/16) consecutive beats, 16
+ * channels per beat (image pixels: 3 used lanes, the rest zero).  All
+ * three stages are 3×3 / stride 1 / pad 1 with 2×2 stride-2 pooling.
+ * ========================================================================= */
 
-    Fetch_Layer(input_dram, weights_dram, input_stream, weight_stream,
-                in_channels, out_channels, in_height, in_width,
-                kernel_size, stride, padding, out_height, out_width);
+/* ---- Lane-wise max of two 16-element packages (2×2 pool) ---- */
+static inline vec_t vec_max(vec_t a, vec_t b) {
+    #pragma HLS INLINE
+    vec_t m;
+    VMAX_LANE: for (int l = 0; l < ELEMS_PER_WORD; l++) {
+        #pragma HLS UNROLL
+        data_t x, y;
+        x.range(15, 0) = a.range(l*16+15, l*16);
+        y.range(15, 0) = b.range(l*16+15, l*16);
+        data_t mx = (x > y) ? x : y;
+        m.range(l*16+15, l*16) = mx.range(15, 0);
+    }
+    return m;
+}
 
-    Execute_Layer(input_stream, weight_stream, output_stream, bn_params_dram,
-                  in_channels, out_channels, out_height, out_width,
-                  kernel_size, use_leaky);
+/* =========================================================================
+ * FUSED STAGE 0: READ IMAGE ROWS
+ *
+ * One burst per channel row (up to 27 words), scattered into a 3 × W row
+ * buffer, then streamed as one 3-lane beat per pixel.  Rows are addressed
+ * through the same input view as Fetch_Layer, so the image can be a crop
+ * of a larger frame.
+ * ========================================================================= */
+static void Fuse_Read(
+    wide_t* input_dram,
+    vec_stream_t& in_stream,
+    int height, int width,
+    int in_ic_offset, int row_pitch, int plane_pitch, int view_origin
+) {
+    PROF_STAGE("Fuse_Read");
+
+    data_t row_buf[FUSE_C0][FUSE_MAX_W];
+    #pragma HLS ARRAY_PARTITION variable=row_buf dim=1 complete
+
+    wide_t dma_strip[DMA_STRIP_WORDS];
+
+    FR_ROW: for (int r = 0; r < height; r++) {
+    #pragma HLS LOOP_TRIPCOUNT min=8 max=416 avg=416
+        FR_IC: for (int ic = 0; ic < FUSE_C0; ic++) {
+            int row_base   = (in_ic_offset + ic) * plane_pitch + r * row_pitch + view_origin;
+            int first_word = row_base >> 4;
+            int last_word  = (row_base + width - 1) >> 4;
+            int n_words    = last_word - first_word + 1;
+
+            FR_BURST: for (int w = 0; w < n_words; w++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=27 avg=27
+                #pragma HLS PIPELINE II=1
+                dma_strip[w] = input_dram[first_word + w];
+            }
+            PROF_CYCLES(PROF_AXI_LATENCY + n_words);
+
+            FR_SCATTER: for (int j = 0; j < width; j++) {
+            #pragma HLS LOOP_TRIPCOUNT min=8 max=416 avg=416
+                #pragma HLS PIPELINE II=1
+                int abs_idx = row_base + j;
+                row_buf[ic][j] = extract_elem(dma_strip[(abs_idx >> 4) - first_word],
+                                              abs_idx & 0xF);
+            }
+            PROF_CYCLES(width);
+        }
+
+        FR_STREAM: for (int j = 0; j < width; j++) {
+        #pragma HLS LOOP_TRIPCOUNT min=8 max=416 avg=416
+            #pragma HLS PIPELINE II=1
+            vec_t pkg = 0;
+            FR_PACK: for (int ic = 0; ic < FUSE_C0; ic++) {
+                #pragma HLS UNROLL
+                pkg.range(ic*16+15, ic*16) = row_buf[ic][j].range(15, 0);
+            }
+            in_stream.write(pkg);
+        }
+    }
+}
+
+/* =========================================================================
+ * FUSED STAGE 0b: PARAMETER LOADER
+ *
+ * The only reader of gmem2 in fused mode.  Each stage's block is its
+ * bias words (16 per beat) followed by its BN-folded OIHW weight words,
+ * contiguous in DRAM, so one burst per stage feeds its parameter FIFO.
+ * Every stage drains its parameters before touching pixel data, so the
+ * three sends simply run back to back.
+ * ========================================================================= */
+static void fuse_send_params(
+    wide_t* weights_dram,
+    vec_stream_t& prm_stream,
+    int base, int n_words
+) {
+    #pragma HLS INLINE
+    PROF_CYCLES(PROF_AXI_LATENCY);
+    FP_BURST: for (int w = 0; w < n_words; w++) {
+    #pragma HLS LOOP_TRIPCOUNT min=28 max=1156 avg=491
+        #pragma HLS PIPELINE II=1
+        vec_t pkg;
+        pkg.range(255, 0) = weights_dram[base + w].range(255, 0);
+        prm_stream.write(pkg);
+    }
+}
+
+/* words per fused stage: COUT/16 bias words + padded OIHW weights */
+#define FUSE_PRM_WORDS(cin, cout) \
+    ((cout) / 16 + ((cout) * (cin) * K_MAX * K_MAX + 15) / 16)
 
-    Write_Layer(output_dram, output_stream, out_channels, out_height, out_width,
-                use_pool, pool_stride);
+static void Fuse_Params(
+    wide_t* weights_dram,
+    vec_stream_t& prm1, vec_stream_t& prm2, vec_stream_t& prm3
+) {
+    PROF_STAGE("Fuse_Params");
+    const int n1 = FUSE_PRM_WORDS(FUSE_C0, FUSE_C1);
+    const int n2 = FUSE_PRM_WORDS(FUSE_C1, FUSE_C2);
+    const int n3 = FUSE_PRM_WORDS(FUSE_C2, FUSE_C3);
+
+    fuse_send_params(weights_dram, prm1, 0,       n1);
+    fuse_send_params(weights_dram, prm2, n1,      n2);
+    fuse_send_params(weights_dram, prm3, n1 + n2, n3);
+}
+
+/* =========================================================================
+ * FUSED STAGE 1–3: CONV 3×3 + BN + ACTIVATE + 2×2 POOL (row streaming)
+ *
+ * Line buffer: 3 input rows in a ring (slots rotate, no data moves).  While
+ * row r is computed from rows r-1, r, r+1, nothing else is resident; row
+ * r+2 is pulled from the upstream FIFO at the start of the next row.
+ *
+ *  upstream ──→ ┌ line_buf[3][W][CIN/16] ┐ ──→ 16×16 MAC ──→ BN/act
+ *               └─────────── ring ───────┘                     │
+ *  downstream ←── pooled row (odd rows) ←── pool_buf[W/2] ←────┘
+ *
+ * One flattened II=1 loop per row walks (col, OC tile, IC tile, ky, kx):
+ * COUT/16 · ceil(CIN/16) · 9 cycles per pixel (conv1 9, conv2 18,
+ * conv3 72), so the three stages are roughly rate-balanced with conv1 the
+ * slowest.  Only min(CIN,16) IC lanes are built, so conv1 uses 48 DSPs.
+ * ========================================================================= */
+template <int CIN, int COUT>
+static void Fuse_ConvPool(
+    vec_stream_t& in_stream,
+    vec_stream_t& prm_stream,
+    vec_stream_t& out_stream,
+    int height, int width, int use_leaky
+) {
+    PROF_STAGE(COUT == FUSE_C1 ? "Fuse_Conv1" :
+               COUT == FUSE_C2 ? "Fuse_Conv2" : "Fuse_Conv3");
+    const int CIN_T  = (CIN + TILE_IC - 1) / TILE_IC;    /* beats per input px  */
+    const int COUT_T = COUT / TILE_OC;                   /* beats per output px */
+    const int LANES  = (CIN < TILE_IC) ? CIN : TILE_IC;  /* IC lanes built      */
+    const int KK     = K_MAX * K_MAX;
+    const int N_WBLK = COUT_T * CIN_T * KK;              /* MAC cycles per px   */
+
+    /* ---- Weight store: [OC tile][IC tile][tap] × 16 OC × 16 IC ---- */
+    data_t wt[N_WBLK][TILE_OC][TILE_IC];
+    #pragma HLS ARRAY_PARTITION variable=wt dim=2 complete
+    #pragma HLS ARRAY_PARTITION variable=wt dim=3 complete
+
+    data_t bias_buf[COUT_T][TILE_OC];
+    #pragma HLS ARRAY_PARTITION variable=bias_buf dim=2 complete
+
+    /* ---- Line buffer ring + pooled-row scratch ---- */
+    vec_t line_buf[K_MAX][FUSE_MAX_W][CIN_T];
+    #pragma HLS ARRAY_PARTITION variable=line_buf dim=1 complete
+    #pragma HLS BIND_STORAGE variable=line_buf type=ram_2p impl=bram
+
+    vec_t pool_buf[FUSE_MAX_W / 2][COUT_T];
+
+    mac_t acc[TILE_OC];
+    #pragma HLS ARRAY_PARTITION variable=acc complete
+
+    /* -- Parameters: bias beats (16 per beat), then folded weights -- */
+    LD_BIAS: for (int b = 0; b < COUT_T; b++) {
+        #pragma HLS PIPELINE II=1
+        vec_t pkg = prm_stream.read();
+        LD_BIAS_UNPACK: for (int oc = 0; oc < TILE_OC; oc++) {
+            #pragma HLS UNROLL
+            bias_buf[b][oc].range(15, 0) = pkg.range(oc*16+15, oc*16);
+        }
+    }
+
+    CLR_WT: for (int b = 0; b < N_WBLK; b++) {
+        #pragma HLS PIPELINE II=1
+        CLR_WT_OC: for (int oc = 0; oc < TILE_OC; oc++) {
+            #pragma HLS UNROLL
+            CLR_WT_IC: for (int ic = 0; ic < TILE_IC; ic++) {
+                #pragma HLS UNROLL
+                wt[b][oc][ic] = 0;
+            }
+        }
+    }
+    PROF_CYCLES(N_WBLK);
+
+    /* OIHW element stream → [blk][oc][ic] (one element per cycle) */
+    {
+        int   oc = 0, ic = 0, k = 0;
+        vec_t w_pkg = 0;
+        LD_WT: for (int e = 0; e < COUT * CIN * KK; e++) {
+            #pragma HLS PIPELINE II=1
+            int slot = e & 0xF;
+            if (slot == 0) w_pkg = prm_stream.read();
+            int blk = ((oc >> 4) * CIN_T + (ic >> 4)) * KK + k;
+            wt[blk][oc & 0xF][ic & 0xF].range(15, 0) =
+                w_pkg.range(slot*16+15, slot*16);
+            if (k == KK - 1) {
+                k = 0;
+                if (ic == CIN - 1) { ic = 0; oc++; }
+                else               { ic++; }
+            } else {
+                k++;
+            }
+        }
+        PROF_CYCLES(COUT * CIN * KK - (COUT * CIN * KK + 15) / 16);
+    }
+
+    /* ==== ROW LOOP: r = -1 only primes the ring with row 0 ==== */
+    int s_top = 0, s_mid = 1, s_bot = 2;      /* ring slots of r-1, r, r+1 */
+
+    FC_ROW: for (int r = -1; r < height; r++) {
+    #pragma HLS LOOP_TRIPCOUNT min=9 max=417 avg=209
+
+        /* -- Pull row r+1 into the free slot -- */
+        if (r + 1 < height) {
+            FC_LOAD_COL: for (int j = 0; j < width; j++) {
+            #pragma HLS LOOP_TRIPCOUNT min=8 max=416 avg=208
+                FC_LOAD_IC: for (int it = 0; it < CIN_T; it++) {
+                    #pragma HLS PIPELINE II=1
+                    line_buf[s_bot][j][it] = in_stream.read();
+                }
+            }
+        }
+
+        if (r >= 0) {
+            int c = 0, ot = 0, it = 0, ky = 0, kx = 0;
+
+            FC_MAC: for (int t = 0; t < width * N_WBLK; t++) {
+            #pragma HLS LOOP_TRIPCOUNT min=72 max=7488 avg=3744
+                #pragma HLS PIPELINE II=1
+                #pragma HLS DEPENDENCE variable=pool_buf inter false
+#if MAC_CASCADE
+                #pragma HLS EXPRESSION_BALANCE off
+#endif
+
+                int  rr   = r + ky - 1;
+                int  cc   = c + kx - 1;
+                bool ok   = (rr >= 0) && (rr < height) && (cc >= 0) && (cc < width);
+                int  slot = (ky == 0) ? s_top : (ky == 1) ? s_mid : s_bot;
+                vec_t in_pkg = ok ? line_buf[slot][cc][it] : (vec_t)0;
+
+                int  blk   = (ot * CIN_T + it) * KK + ky * K_MAX + kx;
+                bool first = (it == 0) && (ky == 0) && (kx == 0);
+                bool last  = (it == CIN_T - 1) && (ky == K_MAX - 1) && (kx == K_MAX - 1);
+
+                /* 16 OC × LANES IC MACs per cycle */
+                FC_OC: for (int oc = 0; oc < TILE_OC; oc++) {
+                    #pragma HLS UNROLL
+                    mac_t dot = 0;
+                    FC_IC: for (int ic = 0; ic < LANES; ic++) {
+                        #pragma HLS UNROLL
+                        data_t w_val = wt[blk][oc][ic];
+                        data_t in_val;
+                        in_val.range(15, 0) = in_pkg.range(ic*16+15, ic*16);
+                        mac_t prod = mac_prod(w_val, in_val);
+                        #pragma HLS BIND_OP variable=prod op=mul impl=dsp
+                        dot += prod;
+                    }
+                    acc[oc] = (first ? (mac_t)0 : acc[oc]) + dot;
+                }
+
+                /* -- OC tile done: BN + act, fold into the 2×2 pool window -- */
+                if (last) {
+                    vec_t px;
+                    FC_BN_OC: for (int oc = 0; oc < TILE_OC; oc++) {
+                        #pragma HLS UNROLL
+                        data_t res = activate((data_t)(mac_to_acc(acc[oc]) + bias_buf[ot][oc]),
+                                              use_leaky);
+                        px.range(oc*16+15, oc*16) = res.range(15, 0);
+                    }
+                    bool  open   = ((r & 1) == 0) && ((c & 1) == 0);
+                    vec_t pooled = open ? px : vec_max(pool_buf[c >> 1][ot], px);
+                    pool_buf[c >> 1][ot] = pooled;
+                    if ((r & 1) && (c & 1)) out_stream.write(pooled);
+                    else                    PROF_CYCLES(1);
+                } else {
+                    PROF_CYCLES(1);
+                }
+
+                /* -- Advance (col, OC tile, IC tile, ky, kx) -- */
+                if (kx == K_MAX - 1) {
+                    kx = 0;
+                    if (ky == K_MAX - 1) {
+                        ky = 0;
+                        if (it == CIN_T - 1) {
+                            it = 0;
+                            if (ot == COUT_T - 1) { ot = 0; c++; }
+                            else                  { ot++; }
+                        } else {
+                            it++;
+                        }
+                    } else {
+                        ky++;
+                    }
+                } else {
+                    kx++;
+                }
+            }
+        }
+
+        /* -- Rotate the ring: the oldest row's slot becomes free -- */
+        int s_free = s_top;
+        s_top = s_mid;
+        s_mid = s_bot;
+        s_bot = s_free;
+    }
+}
+
+/* =========================================================================
+ * FUSED STAGE 4: WRITE POOLED CONV3 ROWS
+ *
+ * Collects one pooled output row (64 channels), then per channel runs the
+ * same edge-read → pack → burst-write sequence as Write_Layer, including
+ * the ACT8 pack when out_act_shift ≥ 0 (the image input stays 16-bit).
+ * ========================================================================= */
+static void Fuse_Write(
+    wide_t* output_dram,
+    vec_stream_t& out_stream,
+    int out_height, int out_width,
+    int out_act_shift
+) {
+    PROF_STAGE("Fuse_Write");
+    const int OT = FUSE_C3 / TILE_OC;
+    int es = (out_act_shift >= 0) ? 5 : 4;
+    int em = (1 << es) - 1;
+
+    data_t row_buf[OT][TILE_OC][FUSE_MAX_W / 8];
+    #pragma HLS ARRAY_PARTITION variable=row_buf dim=2 complete
+
+    wide_t dma_out[DMA_OUT_WORDS];
+
+    FW_ROW: for (int r = 0; r < out_height; r++) {
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=52 avg=52
+        FW_RD_COL: for (int j = 0; j < out_width; j++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=52 avg=52
+            FW_RD_OT: for (int ot = 0; ot < OT; ot++) {
+                #pragma HLS PIPELINE II=1
+                vec_t pkg = out_stream.read();
+                FW_UNPACK: for (int oc = 0; oc < TILE_OC; oc++) {
+                    #pragma HLS UNROLL
+                    row_buf[ot][oc][j].range(15, 0) = pkg.range(oc*16+15, oc*16);
+                }
+            }
+        }
+
+        FW_OC: for (int oc = 0; oc < FUSE_C3; oc++) {
+            int base_idx   = (oc * out_height + r) * out_width;
+            int first_word = base_idx >> es;
+            int start_slot = base_idx & em;
+            int end_idx    = base_idx + out_width - 1;
+            int last_word  = end_idx >> es;
+            int n_words    = last_word - first_word + 1;
+
+            EDGE_RD_FUSE: for (int w = 0; w < n_words; w++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=5 avg=4
+                #pragma HLS PIPELINE II=1
+                if ((w == 0 && start_slot != 0) ||
+                    (w == n_words - 1 && (end_idx & em) != em)) {
+                    dma_out[w] = output_dram[first_word + w];
+                } else {
+                    dma_out[w] = (wide_t)0;
+                }
+            }
+            PROF_CYCLES(PROF_AXI_LATENCY + n_words);
+
+            PACK_FUSE: for (int j = 0; j < out_width; j++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=52 avg=52
+                #pragma HLS PIPELINE II=1
+                int flat = base_idx + j;
+                insert_act(dma_out[(flat >> es) - first_word], flat & em,
+                           row_buf[oc >> 4][oc & 0xF][j], out_act_shift);
+            }
+            PROF_CYCLES(out_width);
+
+            BURST_WR_FUSE: for (int w = 0; w < n_words; w++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=5 avg=4
+                #pragma HLS PIPELINE II=1
+                output_dram[first_word + w] = dma_out[w];
+            }
+            PROF_CYCLES(n_words);
+        }
+    }
+}
+
+/* =========================================================================
+ * FUSED DATAFLOW CORE — six processes, no DRAM between conv1 and conv3
+ * ========================================================================= */
+static void fuse_dataflow(
+    wide_t* input_dram,
+    wide_t* output_dram,
+    wide_t* weights_dram,
+    int h0, int w0, int h1, int w1, int h2, int w2, int h3, int w3,
+    int use_leaky,   int out_act_shift,
+    int in_ic_offset, int row_pitch, int plane_pitch, int view_origin
+) {
+    #pragma HLS DATAFLOW
+
+    vec_stream_t fuse_in("fuse_in");
+    vec_stream_t fuse_c1("fuse_c1");
+    vec_stream_t fuse_c2("fuse_c2");
+    vec_stream_t fuse_out("fuse_out");
+    vec_stream_t prm1("fuse_prm1");
+    vec_stream_t prm2("fuse_prm2");
+    vec_stream_t prm3("fuse_prm3");
+
+    #pragma HLS STREAM variable=fuse_in  depth=FUSE_STREAM_DEPTH
+    #pragma HLS STREAM variable=fuse_c1  depth=FUSE_STREAM_DEPTH
+    #pragma HLS STREAM variable=fuse_c2  depth=FUSE_STREAM_DEPTH
+    #pragma HLS STREAM variable=fuse_out depth=FUSE_STREAM_DEPTH
+    #pragma HLS STREAM variable=prm1     depth=FUSE_PARAM_DEPTH
+    #pragma HLS STREAM variable=prm2     depth=FUSE_PARAM_DEPTH
+    #pragma HLS STREAM variable=prm3     depth=FUSE_PARAM_DEPTH
+
+    Fuse_Read(input_dram, fuse_in, h0, w0,
+              in_ic_offset, row_pitch, plane_pitch, view_origin);
+
+    Fuse_Params(weights_dram, prm1, prm2, prm3);
+
+    Fuse_ConvPool<FUSE_C0, FUSE_C1>(fuse_in, prm1, fuse_c1, h0, w0, use_leaky);
+    Fuse_ConvPool<FUSE_C1, FUSE_C2>(fuse_c1, prm2, fuse_c2, h1, w1, use_leaky);
+    Fuse_ConvPool<FUSE_C2, FUSE_C3>(fuse_c2, prm3, fuse_out, h2, w2, use_leaky);
+
+    Fuse_Write(output_dram, fuse_out, h3, w3, out_act_shift);
+}
+
+/* =========================================================================
+ * ONE LAYER — guards, derived geometry, then the fused or tiled pipeline
+ *
+ * A direct-mode call runs it once on the registers; job-queue mode runs
+ * it once per descriptor (see conv_engine below).
+ * ========================================================================= */
+static void conv_layer(
+    wide_t* input_dram,
+    wide_t* output_dram,
+    wide_t* weights_dram,
+    int*    ic_map_dram,
+    int*    oc_map_dram,
+    wide_t* residual_dram,
+    int in_channels,  int out_channels,
+    int in_height,    int in_width,
+    int kernel_size,  int stride,
+    int pad_top,      int pad_bottom,
+    int pad_left,     int pad_right,
+    int use_pool,     int pool_stride,
+    int pool_pad_bottom, int pool_pad_right,
+    int use_leaky,
+    int use_chan_map,
+    int wt_int8,
+    int fuse_early,
+    int in_act_shift,
+    int out_act_shift,
+    int use_upsample,
+    int use_add,
+    int oc_offset,
+    int total_out_channels,
+    int in_ic_offset,
+    int in_row_pitch,
+    int in_plane_pitch,
+    int in_row0,
+    int in_col0,
+    int groups,
+    int*    stats_dram,
+    wide_t* next_weights_dram,
+    int next_wt_blocks,
+    int next_wt_blk_words,
+    int next_wt_stride,
+    int wt_staged
+) {
+    /* ---- Weight prefetch stage: only the layer right after the one that
+     *      filled it may use it; every early return below drops it ---- */
+    static bool stage_live = false;
+    int staged = wt_staged && stage_live;
+    stage_live = false;
+
+    if (in_act_shift > 8 || out_act_shift > 8) return;
+
+    /* ---- Input view: in_height × in_width window at (in_row0, in_col0)
+     *      of planes in_ic_offset.. (0 pitches: dense, the window is the
+     *      whole tensor) ---- */
+    int row_pitch   = in_row_pitch   ? in_row_pitch   : in_width;
+    int plane_pitch = in_plane_pitch ? in_plane_pitch : row_pitch * in_height;
+    int view_origin = in_row0 * row_pitch + in_col0;
+    if (in_ic_offset < 0 || in_row0 < 0 || in_col0 < 0 ||
+        in_col0 + in_width > row_pitch) return;
+
+    /* ---- Fused conv1→conv3 mode: only in_height/in_width/use_leaky,
+     *      out_act_shift and the input view used ---- */
+    if (fuse_early) {
+        if ((in_height & 7) || (in_width & 7) || in_width > FUSE_MAX_W) return;
+        fuse_dataflow(input_dram, output_dram, weights_dram,
+                      in_height,      in_width,
+                      in_height >> 1, in_width >> 1,
+                      in_height >> 2, in_width >> 2,
+                      in_height >> 3, in_width >> 3,
+                      use_leaky, out_act_shift,
+                      in_ic_offset, row_pitch, plane_pitch, view_origin);
+        return;
+    }
+
+    if (kernel_size > K_MAX) return;
+    if (stride < 1 || stride > MAX_STRIDE) return;
+    if (in_channels > MAX_CHANNELS || out_channels > MAX_CHANNELS) return;
+
+    /* ---- Concat slice: this layer owns planes oc_offset.. of a
+     *      total_out_channels-plane tensor (0: just its own planes) ---- */
+    int total_oc = total_out_channels ? total_out_channels : out_channels;
+    if (oc_offset < 0 || (!use_chan_map && oc_offset + out_channels > total_oc)) return;
+
+    /* ---- Groups (0/1: dense): depthwise, or whole 16-channel tiles per
+     *      group; other shapes are expanded to dense by the host ---- */
+    int  n_grp = (groups > 1) ? groups : 1;
+    bool dw    = (n_grp > 1) && (n_grp == in_channels);
+    bool grp_ok = (n_grp == 1)
+               || (dw ? (out_channels == in_channels)
+                      : (in_channels  % (n_grp * TILE_IC) == 0 &&
+                         out_channels % (n_grp * TILE_OC) == 0));
+    if (!grp_ok) return;
+
+    /* ---- Compute output dimensions (Verilog: combinational logic) ---- */
+    int out_height = (in_height + pad_top  + pad_bottom - kernel_size) / stride + 1;
+    int out_width  = (in_width  + pad_left + pad_right  - kernel_size) / stride + 1;
+
+    /* ---- Tile grid: a 2×2 stride-1 pool needs one row/col past each
+     *      tile, so tiles overlap by one and cover the pooled extent ---- */
+    int tile_ovl = (use_pool && pool_stride == 1) ? 1 : 0;
+    int grid_h   = tile_ovl ? out_height + pool_pad_bottom - 1 : out_height;
+    int grid_w   = tile_ovl ? out_width  + pool_pad_right  - 1 : out_width;
+
+    conv_dataflow(input_dram, output_dram, weights_dram, residual_dram,
+                  ic_map_dram, oc_map_dram, stats_dram, next_weights_dram,
+                  in_channels, out_channels, in_height, in_width,
+                  kernel_size, stride, pad_top, pad_left, pad_right,
+                  use_pool, pool_stride, pool_pad_bottom, pool_pad_right,
+                  use_leaky, use_chan_map, wt_int8,
+                  in_act_shift, out_act_shift, use_upsample, use_add, oc_offset,
+                  in_ic_offset, row_pitch, plane_pitch, view_origin, n_grp,
+                  next_wt_blocks, next_wt_blk_words, next_wt_stride, staged,
+                  out_height, out_width, grid_h, grid_w, tile_ovl);
+    stage_live = (next_wt_blocks > 0);
 }
 
 /* =========================================================================
@@ -787,21 +2316,85 @@ static void conv_dataflow(
  *
  * Port mapping:
  *   gmem0 (256-bit, READ)  ← input_dram   (activations)
+ *                          ← ic_map_dram  (pruned-channel remap, 32-bit)
  *   gmem1 (256-bit, R/W)   ← output_dram  (output feature map)
+ *                          ← residual_dram (use_add: tensor to add)
+ *                          ← oc_map_dram  (pruned-channel remap, 32-bit)
+ *                          → stats_dram   (per-layer activation statistics)
  *   gmem2 (256-bit, READ)  ← weights_dram (convolution weights)
- *   gmem3 (16-bit,  READ)  ← bn_params    (batch-norm scale/bias)
+ *                          ← next_weights_dram (next layer's, prefetch)
+ *   (BN is folded into the weights; bias rides in each weight block.  The
+ *   32-bit side ports ride the bundle of the one process that uses them —
+ *   Fetch_Layer reads ic_map, Write_Layer oc_map and stats — each once per
+ *   layer, outside the tile loops, so there is no gmem3.)
  *   s_axi_control           ← all scalar parameters
+ *                           ← job_queue (JOBQ_DEPTH descriptor slots, RAM)
+ *
+ * JOB QUEUE (job_tail > 0): the host writes layer descriptors into the
+ * job_queue ring over AXI-Lite (job n in slot n mod JOBQ_DEPTH, layout
+ * JOB_* in conv_engine.h) and publishes the count in job_tail.  Each
+ * invocation runs up to job_batch of them from job_head, reports the new
+ * head in jobs_done, and ends with ap_done — the interrupt.  With
+ * auto_restart set, the engine starts again immediately, picks up the
+ * latest job_tail, and keeps draining; the host sleeps on the interrupt
+ * instead of polling ap_ctrl and refills slots below jobs_done.
+ * Empty restarts: an invocation that finds the ring empty still raises
+ * ap_done, but runs nothing and sets job_empty — not a completion; the
+ * host drops it.  They only happen when the ring drains before a refill,
+ * which a job_batch below JOBQ_DEPTH avoids at normal host latency, and
+ * they stop once the host clears auto_restart (as soon as the last job is
+ * queued; the tail finishes with single starts while jobs_done <
+ * job_tail).  Descriptor pointers are word offsets from the pointer
+ * registers, which the host points at one common base.  Direct mode
+ * (job_tail = 0) copies the registers into the same descriptor, so both
+ * modes share one conv_layer instance; it also resets the head, as
+ * job_tail < 0 alone does (start of a session).
+ *
+ *  host ──AXI-Lite──→ ┌──────────────────────┐   job_head
+ *   job_tail          │ slot 0 │ 1 │ … │ 15  │ ──→ conv_layer ──→ ap_done/irq
+ *                     └──────────────────────┘   (job_batch per start)
  * ========================================================================= */
 extern "C" void conv_engine(
     wide_t* input_dram,
     wide_t* output_dram,
     wide_t* weights_dram,
-    data_t* bn_params_dram,
+    int*    ic_map_dram,
+    int*    oc_map_dram,
+    wide_t* residual_dram,
     int in_channels,  int out_channels,
     int in_height,    int in_width,
-    int kernel_size,  int stride, int padding,
+    int kernel_size,  int stride,
+    int pad_top,      int pad_bottom,
+    int pad_left,     int pad_right,
     int use_pool,     int pool_stride,
-    int use_leaky
+    int pool_pad_bottom, int pool_pad_right,
+    int use_leaky,
+    int use_chan_map,
+    int wt_int8,
+    int fuse_early,
+    int in_act_shift,
+    int out_act_shift,
+    int use_upsample,
+    int use_add,
+    int oc_offset,
+    int total_out_channels,
+    int in_ic_offset,
+    int in_row_pitch,
+    int in_plane_pitch,
+    int in_row0,
+    int in_col0,
+    int groups,
+    int*    stats_dram,
+    wide_t* next_weights_dram,
+    int next_wt_blocks,
+    int next_wt_blk_words,
+    int next_wt_stride,
+    int wt_staged,
+    int job_tail,
+    int job_batch,
+    int job_queue[JOBQ_DEPTH * JOB_WORDS],
+    int*    jobs_done,
+    int*    job_empty
 ) {
     /* ---- AXI master ports (Verilog: AXI4 master interfaces) ----
      * max_read/write_burst_length enables the DMA staging approach.
@@ -812,13 +2405,29 @@ extern "C" void conv_engine(
         max_read_burst_length=64 max_write_burst_length=64
     #pragma HLS INTERFACE m_axi port=weights_dram  bundle=gmem2 depth=5000000 \
         max_read_burst_length=64
-    #pragma HLS INTERFACE m_axi port=bn_params_dram bundle=gmem3 depth=4096
+    /* Remap tables and statistics: one short burst per layer each, on the
+     * bundle of the process that owns them */
+    #pragma HLS INTERFACE m_axi port=ic_map_dram    bundle=gmem0 depth=1024
+    #pragma HLS INTERFACE m_axi port=oc_map_dram    bundle=gmem1 depth=1024
+    /* Per-layer activation statistics (STAT_WORDS ints, written once) */
+    #pragma HLS INTERFACE m_axi port=stats_dram     bundle=gmem1 depth=20
+    /* Next layer's weights: prefetched by Fetch_Weights on its own port */
+    #pragma HLS INTERFACE m_axi port=next_weights_dram bundle=gmem2 depth=5000000 \
+        max_read_burst_length=64
+    /* Residual shares gmem1: only Write_Layer touches either pointer, and
+     * it reads a tile's residual words before writing any of its output */
+    #pragma HLS INTERFACE m_axi port=residual_dram  bundle=gmem1 depth=1000000 \
+        max_read_burst_length=64
 
     /* ---- AXI-Lite slave control (Verilog: s_axi_control register bank) ---- */
     #pragma HLS INTERFACE s_axilite port=input_dram     bundle=control
     #pragma HLS INTERFACE s_axilite port=output_dram    bundle=control
     #pragma HLS INTERFACE s_axilite port=weights_dram   bundle=control
-    #pragma HLS INTERFACE s_axilite port=bn_params_dram bundle=control
+    #pragma HLS INTERFACE s_axilite port=ic_map_dram    bundle=control
+    #pragma HLS INTERFACE s_axilite port=oc_map_dram    bundle=control
+    #pragma HLS INTERFACE s_axilite port=residual_dram  bundle=control
+    #pragma HLS INTERFACE s_axilite port=stats_dram     bundle=control
+    #pragma HLS INTERFACE s_axilite port=next_weights_dram bundle=control
 
     #pragma HLS INTERFACE s_axilite port=in_channels   bundle=control
     #pragma HLS INTERFACE s_axilite port=out_channels  bundle=control
@@ -826,21 +2435,142 @@ extern "C" void conv_engine(
     #pragma HLS INTERFACE s_axilite port=in_width      bundle=control
     #pragma HLS INTERFACE s_axilite port=kernel_size   bundle=control
     #pragma HLS INTERFACE s_axilite port=stride        bundle=control
-    #pragma HLS INTERFACE s_axilite port=padding       bundle=control
+    #pragma HLS INTERFACE s_axilite port=pad_top       bundle=control
+    #pragma HLS INTERFACE s_axilite port=pad_bottom    bundle=control
+    #pragma HLS INTERFACE s_axilite port=pad_left      bundle=control
+    #pragma HLS INTERFACE s_axilite port=pad_right     bundle=control
     #pragma HLS INTERFACE s_axilite port=use_pool      bundle=control
     #pragma HLS INTERFACE s_axilite port=pool_stride   bundle=control
+    #pragma HLS INTERFACE s_axilite port=pool_pad_bottom bundle=control
+    #pragma HLS INTERFACE s_axilite port=pool_pad_right  bundle=control
     #pragma HLS INTERFACE s_axilite port=use_leaky     bundle=control
+    #pragma HLS INTERFACE s_axilite port=use_chan_map  bundle=control
+    #pragma HLS INTERFACE s_axilite port=wt_int8       bundle=control
+    #pragma HLS INTERFACE s_axilite port=fuse_early    bundle=control
+    #pragma HLS INTERFACE s_axilite port=in_act_shift  bundle=control
+    #pragma HLS INTERFACE s_axilite port=out_act_shift bundle=control
+    #pragma HLS INTERFACE s_axilite port=use_upsample  bundle=control
+    #pragma HLS INTERFACE s_axilite port=use_add       bundle=control
+    #pragma HLS INTERFACE s_axilite port=oc_offset     bundle=control
+    #pragma HLS INTERFACE s_axilite port=total_out_channels bundle=control
+    #pragma HLS INTERFACE s_axilite port=in_ic_offset  bundle=control
+    #pragma HLS INTERFACE s_axilite port=in_row_pitch  bundle=control
+    #pragma HLS INTERFACE s_axilite port=in_plane_pitch bundle=control
+    #pragma HLS INTERFACE s_axilite port=in_row0       bundle=control
+    #pragma HLS INTERFACE s_axilite port=in_col0       bundle=control
+    #pragma HLS INTERFACE s_axilite port=groups        bundle=control
+    #pragma HLS INTERFACE s_axilite port=next_wt_blocks    bundle=control
+    #pragma HLS INTERFACE s_axilite port=next_wt_blk_words bundle=control
+    #pragma HLS INTERFACE s_axilite port=next_wt_stride    bundle=control
+    #pragma HLS INTERFACE s_axilite port=wt_staged     bundle=control
+    #pragma HLS INTERFACE s_axilite port=job_tail      bundle=control
+    #pragma HLS INTERFACE s_axilite port=job_batch     bundle=control
+    #pragma HLS INTERFACE s_axilite port=job_queue     bundle=control
+    #pragma HLS INTERFACE s_axilite port=jobs_done     bundle=control
+    #pragma HLS INTERFACE s_axilite port=job_empty     bundle=control
     #pragma HLS INTERFACE s_axilite port=return        bundle=control
 
-    if (kernel_size > K_MAX) return;
+    /* Next job to run; persists across auto-restarted invocations */
+    static int job_head = 0;
 
-    /* ---- Compute output dimensions (Verilog: combinational logic) ---- */
-    int out_height = (in_height + 2 * padding - kernel_size) / stride + 1;
-    int out_width  = (in_width  + 2 * padding - kernel_size) / stride + 1;
+    /* ====== job_tail < 0: reset the queue (new session), no layer ====== */
+    if (job_tail < 0) {
+        job_head   = 0;
+        *jobs_done = 0;
+        *job_empty = 0;
+        return;
+    }
 
-    conv_dataflow(input_dram, output_dram, weights_dram, bn_params_dram,
-                  in_channels, out_channels, in_height, in_width,
-                  kernel_size, stride, padding,
-                  use_pool, pool_stride, use_leaky,
-                  out_height, out_width);
+    /* ====== One conv_layer instance serves both modes: direct mode
+     *        (job_tail = 0) copies the registers into the same
+     *        descriptor a queued job reads from job_queue ====== */
+    bool direct = (job_tail == 0);
+    if (direct) job_head = 0;
+    int head0 = job_head;               /* unchanged at exit: empty restart */
+
+    /* Up to job_batch queued layers per start, then ap_done (one
+     * interrupt per batch; auto-restart takes the next) */
+    int n_run = direct ? 1 : (job_batch > 0) ? job_batch : JOBQ_DEPTH;
+    JOB_LOOP: for (int n = 0; n < n_run; n++) {
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=16 avg=1
+        if (direct || job_head < job_tail) {
+            int d[JOB_WORDS];
+            if (direct) {
+                d[JOB_IN_OFF]          = 0;  d[JOB_OUT_OFF]        = 0;
+                d[JOB_WT_OFF]          = 0;  d[JOB_IC_MAP_OFF]     = 0;
+                d[JOB_OC_MAP_OFF]      = 0;  d[JOB_RES_OFF]        = 0;
+                d[JOB_STATS_OFF]       = 0;  d[JOB_NEXT_WT_OFF]    = 0;
+                d[JOB_IN_CHANNELS]     = in_channels;
+                d[JOB_OUT_CHANNELS]    = out_channels;
+                d[JOB_IN_HEIGHT]       = in_height;
+                d[JOB_IN_WIDTH]        = in_width;
+                d[JOB_KERNEL_SIZE]     = kernel_size;
+                d[JOB_STRIDE]          = stride;
+                d[JOB_PAD_TOP]         = pad_top;
+                d[JOB_PAD_BOTTOM]      = pad_bottom;
+                d[JOB_PAD_LEFT]        = pad_left;
+                d[JOB_PAD_RIGHT]       = pad_right;
+                d[JOB_USE_POOL]        = use_pool;
+                d[JOB_POOL_STRIDE]     = pool_stride;
+                d[JOB_POOL_PAD_BOTTOM] = pool_pad_bottom;
+                d[JOB_POOL_PAD_RIGHT]  = pool_pad_right;
+                d[JOB_USE_LEAKY]       = use_leaky;
+                d[JOB_USE_CHAN_MAP]    = use_chan_map;
+                d[JOB_WT_INT8]         = wt_int8;
+                d[JOB_FUSE_EARLY]      = fuse_early;
+                d[JOB_IN_ACT_SHIFT]    = in_act_shift;
+                d[JOB_OUT_ACT_SHIFT]   = out_act_shift;
+                d[JOB_USE_UPSAMPLE]    = use_upsample;
+                d[JOB_USE_ADD]         = use_add;
+                d[JOB_OC_OFFSET]       = oc_offset;
+                d[JOB_TOTAL_OUT_CHANNELS] = total_out_channels;
+                d[JOB_IN_IC_OFFSET]    = in_ic_offset;
+                d[JOB_IN_ROW_PITCH]    = in_row_pitch;
+                d[JOB_IN_PLANE_PITCH]  = in_plane_pitch;
+                d[JOB_IN_ROW0]         = in_row0;
+                d[JOB_IN_COL0]         = in_col0;
+                d[JOB_GROUPS]          = groups;
+                d[JOB_NEXT_WT_BLOCKS]  = next_wt_blocks;
+                d[JOB_NEXT_WT_BLK_WORDS] = next_wt_blk_words;
+                d[JOB_NEXT_WT_STRIDE]  = next_wt_stride;
+                d[JOB_WT_STAGED]       = wt_staged;
+            } else {
+                JOB_RD: for (int k = 0; k < JOB_WORDS; k++) {
+                    #pragma HLS PIPELINE II=1
+                    d[k] = job_queue[(job_head & (JOBQ_DEPTH - 1)) * JOB_WORDS + k];
+                }
+            }
+            conv_layer(input_dram    + d[JOB_IN_OFF],
+                       output_dram   + d[JOB_OUT_OFF],
+                       weights_dram  + d[JOB_WT_OFF],
+                       ic_map_dram   + d[JOB_IC_MAP_OFF],
+                       oc_map_dram   + d[JOB_OC_MAP_OFF],
+                       residual_dram + d[JOB_RES_OFF],
+                       d[JOB_IN_CHANNELS],   d[JOB_OUT_CHANNELS],
+                       d[JOB_IN_HEIGHT],     d[JOB_IN_WIDTH],
+                       d[JOB_KERNEL_SIZE],   d[JOB_STRIDE],
+                       d[JOB_PAD_TOP],       d[JOB_PAD_BOTTOM],
+                       d[JOB_PAD_LEFT],      d[JOB_PAD_RIGHT],
+                       d[JOB_USE_POOL],      d[JOB_POOL_STRIDE],
+                       d[JOB_POOL_PAD_BOTTOM], d[JOB_POOL_PAD_RIGHT],
+                       d[JOB_USE_LEAKY],     d[JOB_USE_CHAN_MAP],
+                       d[JOB_WT_INT8],       d[JOB_FUSE_EARLY],
+                       d[JOB_IN_ACT_SHIFT],  d[JOB_OUT_ACT_SHIFT],
+                       d[JOB_USE_UPSAMPLE],  d[JOB_USE_ADD],
+                       d[JOB_OC_OFFSET],     d[JOB_TOTAL_OUT_CHANNELS],
+                       d[JOB_IN_IC_OFFSET],  d[JOB_IN_ROW_PITCH],
+                       d[JOB_IN_PLANE_PITCH],
+                       d[JOB_IN_ROW0],       d[JOB_IN_COL0],
+                       d[JOB_GROUPS],
+                       stats_dram        + d[JOB_STATS_OFF],
+                       next_weights_dram + d[JOB_NEXT_WT_OFF],
+                       d[JOB_NEXT_WT_BLOCKS], d[JOB_NEXT_WT_BLK_WORDS],
+                       d[JOB_NEXT_WT_STRIDE], d[JOB_WT_STAGED]);
+            if (!direct) job_head++;
+        }
+    }
+    if (!direct) {
+        *job_empty = (job_head == head0);
+        *jobs_done = job_head;
+    }
 }
@@ -41,16 +41,153 @@ typedef ap_fixed<32, 16, AP_RND, AP_SAT> acc_t;    /* 32-bit MAC accumulator
 typedef ap_int<256>   wide_t;                        /* 256-bit DRAM word (m_axi) */
 typedef ap_uint<256>  vec_t;                         /* 256-bit stream word (16×16b) */
 
+/* MAC datapath, chosen at compile time (-DMAC_CASCADE=1):
+ *  0: per-OC 16-input adder tree in acc_t.  Every add saturates, so the
+ *     tree is 16 carry chains each followed by a clamp — the critical path
+ *     that holds V3 at 167 MHz.
+ *  1: DSP48E2 cascade.  The 16 raw 32-bit products of an OC ripple down a
+ *     PCOUT→PCIN chain (one DSP per IC lane, one register per stage) into
+ *     a 48-bit mac_t that never saturates; acc_buf holds mac_t too.  The
+ *     clamp to acc_t happens once, in the epilogue (and when a partial sum
+ *     spills to psum_buf, which stays 32-bit).  ~16 more cycles of MAC
+ *     latency, same II; targets 200–250 MHz.
+ * Both give bit-identical results unless an acc_t would have saturated. */
+#ifndef MAC_CASCADE
+#define MAC_CASCADE 0
+#endif
+#if MAC_CASCADE
+typedef ap_int<48>    mac_t;                         /* DSP48E2 P register        */
+#else
+typedef acc_t         mac_t;
+#endif
+
+/* W8A16 dequant scale precision, chosen at compile time (-DWT8_SCALE_MANT=1):
+ *  0: the scale header word is a power of two, 2^e — the epilogue is a
+ *     barrel shift + add + activate, no DSPs.  Export rounds each per-OC
+ *     scale to the nearest power of two (~3 dB weight SQNR on Tiny-YOLO's
+ *     int8 layers).
+ *  1: the word also carries an 11-bit mantissa, (1 + m/2048)·2^e, paid
+ *     for with one 32×11 multiply per OC lane on every layer. */
+#ifndef WT8_SCALE_MANT
+#define WT8_SCALE_MANT 0
+#endif
+
 /* =========================================================================
  * DERIVED CONSTANTS — computed at compile time (like Verilog parameters)
  * ========================================================================= */
 #define ELEMS_PER_WORD  16                           /* 256 / 16 bits             */
+#define ACT8_PER_WORD   32                           /* 256 / 8 bits (ACT8)       */
 #define MAX_STRIDE      2
-#define CACHE_H  (TILE_H * MAX_STRIDE + K_MAX - 1)  /* 35                        */
-#define CACHE_W  (TILE_W * MAX_STRIDE + K_MAX - 1)  /* 35                        */
+/* Input window of one output tile: the last output row/col starts at
+ * (TILE-1)·stride and spans K taps                                         */
+#define CACHE_H  ((TILE_H - 1) * MAX_STRIDE + K_MAX)  /* 33                      */
+#define CACHE_W  ((TILE_W - 1) * MAX_STRIDE + K_MAX)  /* 33                      */
+
+/* Flattened compute pass: a pixel's accumulator is revisited once per tap
+ * sweep, so a sweep must span at least the acc_buf read→add→write latency
+ * (COMPUTE_P declares a true acc_buf dependence at that distance, so a
+ * deeper schedule costs II rather than correctness).  Edge tiles with
+ * fewer pixels are padded with bubbles.  The 48-bit mac_t add of
+ * MAC_CASCADE and clocks under 5 ns take a deeper distance.
+ *
+ * 4 is not a measured figure: it is the adder-tree build's load (1-cycle
+ * BRAM read) + saturating 32-bit add + store at 7 ns, plus one cycle of
+ * margin; C-sim asserts every revisit keeps the distance.  run_hls.tcl
+ * passes its clock in as CLK_PERIOD_NS and logs COMPUTE_P's achieved II
+ * and timing after csynth (acc_raw_check.log).                           */
+#ifndef CLK_PERIOD_NS
+#if MAC_CASCADE
+#define CLK_PERIOD_NS   4
+#else
+#define CLK_PERIOD_NS   7
+#endif
+#endif
+#ifndef ACC_RAW_DIST
+#if MAC_CASCADE || CLK_PERIOD_NS < 5
+#define ACC_RAW_DIST    8
+#else
+#define ACC_RAW_DIST    4
+#endif
+#endif
 
 /* Max OC tile steps across all layers (1024/16 = 64 for conv7) */
 #define MAX_OC_STEPS    64
+#define MAX_CHANNELS    (MAX_OC_STEPS * TILE_OC)    /* 1024                  */
+
+/* Channel remap (use_chan_map=1, structurally pruned models): weights and
+ * bias headers hold only the active channels, packed densely so IC/OC tiles
+ * stay full.  Activations keep their unpruned CHW layout in DRAM:
+ *   ic_map[i] = DRAM plane read for compacted input channel i
+ *   oc_map[o] = DRAM plane written for compacted output channel o
+ * in_channels/out_channels count ACTIVE channels, so work scales with the
+ * pruning ratio.  Planes not listed in oc_map are left untouched.        */
+
+/* Grouped convolution (groups = G > 1): input group g feeds only output
+ * group g.  Two shapes run natively; the host expands any other shape to
+ * block-diagonal dense weights (groups = 1).
+ *  - Tile-aligned groups (in/G and out/G multiples of 16): an IC tile
+ *    pairs only with the OC tiles of its own group, so the G−1 zero blocks
+ *    per tile are never fetched or computed.
+ *  - Depthwise (G = in = out, MobileNet): the MAC array is turned on its
+ *    side.  OC lane c is channel c of the tile and IC lane ky·K_MAX + kx is
+ *    one kernel tap, so each pixel is one cycle for all K² taps (144 of 256
+ *    MACs at K=3), not K² cycles on the diagonal.  Fetch streams the tile's
+ *    input window once instead of K² shifted copies.  Execute keeps that
+ *    window in DW_BANKS × DW_BANKS banks interleaved by row/col mod
+ *    DW_BANKS, so the K×K taps of any pixel hit K² different banks.    */
+#define DW_BANKS   K_MAX
+#define DW_WIN_H   ((CACHE_H + DW_BANKS - 1) / DW_BANKS)   /* 11            */
+#define DW_WIN_W   ((CACHE_W + DW_BANKS - 1) / DW_BANKS)   /* 11            */
+
+/* Strided window (stride ≥ 2, dense): the K² shifted copies of the output
+ * grid that Fetch streams at stride 1 hardly overlap any more, so it
+ * streams the tile's input window once, as for depthwise, and Execute
+ * reads tap (ky, kx) of pixel (i, j) from window element
+ * (i·stride + ky, j·stride + kx) in the same banks — one read per cycle.
+ * A full 16×16 stride-2 3×3 tile is 33×33 = 1089 beats instead of 2304. */
+
+/* ACT8 inter-layer storage (in_act_shift / out_act_shift ≥ 0): a feature
+ * map is kept in DRAM as int8, 32 elements per word, in the same CHW order.
+ * Byte q stands for data_t raw bits q << shift (shift 0..8, chosen per map
+ * by the host), so shift 4 covers ±8 in steps of 1/16.  Write_Layer rounds
+ * and saturates on pack, Fetch_Layer sign-extends and shifts on scatter;
+ * streams and MACs stay 16-bit.  A shift of -1 keeps the 16-bit format.  */
+
+/* Row-strip mode (wide layers with a single IC tile, i.e. conv1/conv2,
+ * and stride-2 layers whose IC tiles all fit): Fetch keeps a full-width
+ * strip of (TILE_H-1)·stride + K padded rows per IC tile on chip.  Column
+ * tiles stream from the strip, and the bottom K - stride rows are carried
+ * into the next strip instead of being re-read from DRAM.  Rows are packed
+ * at a pitch of the padded width, so one store serves 18 rows × 418
+ * (stride 1) or 33 rows × 228 over all IC tiles (stride 2: conv2s2–conv4s2
+ * fit; conv1s2 at 418 wide stays on the tiled path).
+ * 16 IC × 18 × 418 × 16b → ~112 BRAM18K                                    */
+#define STRIP_H      (TILE_H + K_MAX - 1)           /* 18                    */
+#define STRIP_MAX_W  (416 + K_MAX - 1)              /* 418: conv1 + padding  */
+#define STRIP_ELEMS  (STRIP_H * STRIP_MAX_W)        /* 7524 per IC lane      */
+
+/* Column-halo reuse (tiled fetch path, conv3–conv5): the right-most
+ * K - stride input columns of every IC tile (the ones adjacent column
+ * tiles share) are kept for the next column tile, so only new columns
+ * are read from DRAM.  Layers with more IC tiles than
+ * HALO_IC_TILES fall back to full refetch (they are 13×13: one column
+ * tile, nothing to reuse).  8 × 16 × 33 × 2 × 16b → ~16 BRAM18K/LUTRAM    */
+#define HALO_IC_TILES 8
+
+/* Fused early-layer mode (fuse_early=1): conv1→pool→conv2→pool→conv3→pool
+ * run as one invocation, streaming rows between three conv+BN+act+2×2-pool
+ * stages through on-chip line buffers.  Only the 3-channel image is read
+ * and only the pooled conv3 map is written; the conv1/conv2 maps never
+ * touch DRAM.  Channel counts are fixed at synthesis time (Tiny-YOLO);
+ * height/width come from in_height/in_width (multiples of 8, ≤ 416).
+ *
+ * Weights: conv1 | conv2 | conv3, each = COUT/16 bias words followed by
+ *          BN-folded OIHW weights padded to a whole 256-bit word.        */
+#define FUSE_C0        3                            /* image channels        */
+#define FUSE_C1        16                           /* conv1 out channels    */
+#define FUSE_C2        32                           /* conv2 out channels    */
+#define FUSE_C3        64                           /* conv3 out channels    */
+#define FUSE_MAX_W     416                          /* conv1 input width     */
 
 /* =========================================================================
  * DMA STAGING BUFFER SIZES (Verilog-like: explicit FIFO/buffer sizing)
@@ -61,19 +198,157 @@ typedef ap_uint<256>  vec_t;                         /* 256-bit stream word (16
  * ========================================================================= */
 
 /* Input line DMA: burst-reads one full row of the input tile
- * Max row width = CACHE_W = 35 elements → ceil(35/16)+1 = 4 words          */
+ * Max row width = CACHE_W = 33 elements → ceil(33/16)+1 = 4 words          */
 #define DMA_LINE_WORDS  4
 
-/* Weight block DMA: burst-reads all weights for one OC channel × all IC
- * 16 IC × K_MAX² = 16×9 = 144 elements = 9 words
- * But weights for consecutive IC channels may span word boundaries,
- * so over-allocate: ceil((144+15) / 16)+1+1 = 12 words                     */
-#define DMA_WT_WORDS    12
+/* Strip row DMA: burst-reads one full input row in row-strip mode
+ * Max row width = 416 elements → ceil(416/16)+1 = 27 words                 */
+#define DMA_STRIP_WORDS 28
+
+/* Plane DMA (single-tile layers, 13×13): burst-reads a whole channel
+ * plane of ≤ PLANE_MAX_ELEMS elements in one transaction
+ * 13×13 = 169 elements → 11 words; max 256/16+1 = 17 words               */
+#define PLANE_MAX_ELEMS (TILE_H * TILE_W)
+#define DMA_PLANE_WORDS (PLANE_MAX_ELEMS / ELEMS_PER_WORD + 1)
+
+/* Pre-tiled weight layout (host export, tiled engine only):
+ *   [oc_tile][ic_tile][ bias[16] | scale[16] | oc 0..15 ][ky][kx][ic 0..15]
+ * BN is folded in by the host: weights carry the BN scale, and each block
+ * starts with two 16-bit header words — per-OC bias and per-OC scale
+ * { m[10:0], e[4:0] } = (1 + m/2048)·2^e, e signed (0 = scale 1 normally;
+ * the W8A16 dequant scale; m is 0 unless WT8_SCALE_MANT).  Channels are
+ * zero-padded to full 16×16 tiles, so block (to, ti) starts at word
+ * (to·ti_steps + ti)·(2 + 16·K²) and each word is one stream beat
+ * (16 lanes).  One burst fetches a whole OC×IC tile:
+ * 2 + 16 OC × K_MAX² = 146 words (2 + 72 as int8, wt_int8=1).
+ * Grouped layers export the [out][in/G] weight tensor the same way, so
+ * block (to, ti) is IC tile ti of OC tile to's own group.  Depthwise
+ * layers hold one block per channel tile, [ bias | scale | ky ][kx][c]:
+ * 2 + K² words (2 + (K²+1)/2 as int8), lane c = channel.
+ * The fused mode keeps plain OIHW, each stage led by its bias words.      */
+#define WT_HDR_BEATS    2
+#define WT_BLOCK_WORDS  (WT_HDR_BEATS + TILE_OC * K_MAX * K_MAX)   /* 146    */
+
+/* Cross-invocation weight prefetch stage (Fetch_Weights): the next
+ * layer's first blocks, loaded while the current layer drains.  1024
+ * words hold 7 dense 3×3 blocks (13 as int8) — IC tile 0 of the first
+ * OC tiles, enough to cover the first weight bursts' latency.            */
+#define WT_STAGE_WORDS  1024
 
 /* Output row DMA: stages one packed output row before burst-writing
  * Max output width = 416 → ceil(416/16)+1 = 27 words                       */
 #define DMA_OUT_WORDS   28
 
+/* Activation statistics block (stats_dram), rewritten by every tiled
+ * layer over all the values it writes (after activation, pool and the
+ * residual add; an upsampled value counts four times), in raw data_t
+ * units (Q8.8 LSBs):
+ *   [ min | max | n_sat | n_total | hist[STAT_BINS] ]
+ * n_sat counts values clipped on the way out: data_t rails (±32767/
+ * -32768) for a 16-bit map, the int8 range after rounding for ACT8.
+ * hist bin b > 0 counts 2^(b-1) ≤ |raw| < 2^b (b = bit length, top bin
+ * open-ended), bin 0 exact zeros.  The fused path leaves it untouched.   */
+#define STAT_MIN        0
+#define STAT_MAX        1
+#define STAT_SAT        2
+#define STAT_COUNT      3
+#define STAT_HIST       4
+#define STAT_BINS       16
+#define STAT_WORDS      (STAT_HIST + STAT_BINS)                    /* 20     */
+
+/* Job queue (job_tail > 0, see TOP LEVEL in conv_engine.cpp): JOBQ_DEPTH
+ * descriptor slots of JOB_WORDS ints in the AXI-Lite address space, job n
+ * in slot n % JOBQ_DEPTH.  A descriptor is one layer: eight pointer
+ * offsets from the pointer registers (in elements of the port's type —
+ * 256-bit words, or ints for the map / stats ports), then the scalar
+ * arguments of a direct call in prototype order.                         */
+#define JOBQ_DEPTH      16                               /* power of two */
+#define JOB_WORDS       64
+#define JOB_IN_OFF              0  /* input_dram         */
+#define JOB_OUT_OFF             1  /* output_dram        */
+#define JOB_WT_OFF              2  /* weights_dram       */
+#define JOB_IC_MAP_OFF          3  /* ic_map_dram        */
+#define JOB_OC_MAP_OFF          4  /* oc_map_dram        */
+#define JOB_RES_OFF             5  /* residual_dram      */
+#define JOB_STATS_OFF           6  /* stats_dram         */
+#define JOB_NEXT_WT_OFF         7  /* next_weights_dram  */
+#define JOB_IN_CHANNELS         8
+#define JOB_OUT_CHANNELS        9
+#define JOB_IN_HEIGHT           10
+#define JOB_IN_WIDTH            11
+#define JOB_KERNEL_SIZE         12
+#define JOB_STRIDE              13
+#define JOB_PAD_TOP             14
+#define JOB_PAD_BOTTOM          15
+#define JOB_PAD_LEFT            16
+#define JOB_PAD_RIGHT           17
+#define JOB_USE_POOL            18
+#define JOB_POOL_STRIDE         19
+#define JOB_POOL_PAD_BOTTOM     20
+#define JOB_POOL_PAD_RIGHT      21
+#define JOB_USE_LEAKY           22
+#define JOB_USE_CHAN_MAP        23
+#define JOB_WT_INT8             24
+#define JOB_FUSE_EARLY          25
+#define JOB_IN_ACT_SHIFT        26
+#define JOB_OUT_ACT_SHIFT       27
+#define JOB_USE_UPSAMPLE        28
+#define JOB_USE_ADD             29
+#define JOB_OC_OFFSET           30
+#define JOB_TOTAL_OUT_CHANNELS  31
+#define JOB_IN_IC_OFFSET        32
+#define JOB_IN_ROW_PITCH        33
+#define JOB_IN_PLANE_PITCH      34
+#define JOB_IN_ROW0             35
+#define JOB_IN_COL0             36
+#define JOB_GROUPS              37
+#define JOB_NEXT_WT_BLOCKS      38
+#define JOB_NEXT_WT_BLK_WORDS   39
+#define JOB_NEXT_WT_STRIDE      40
+#define JOB_WT_STAGED           41
+
+/* =========================================================================
+ * DATAFLOW FIFO DEPTHS (in 256-bit beats)
+ *
+ * Each 256-bit FIFO costs 8 BRAM18K per 512 entries.  Size these from
+ * the C-sim occupancy report (conv_engine_profile.cpp, -DCONV_PROFILE)
+ * rather than by hand.  Its summary at the default 2% stall tolerance,
+ * full layer table:
+ *   input_stream   8192  worst slowdown 2.8% (conv2), over the default
+ *                        tolerance since the strip fetch got faster; the
+ *                        profiler asks for 16384 (0.7%, +116 BRAM18K) and
+ *                        zero stall for 20302 beats — kept at 8192
+ *   weight_stream   512  0% — Fetch_Weights stays ahead of Execute; 512
+ *                        still holds three 3×3 OC-tile blocks
+ *   output_stream   512  0% — Write_Layer keeps up; one 16×16 tile fits
+ * 132 BRAM18K in total, down from 232 at 8192/4096/4096.
+ * ========================================================================= */
+#define INPUT_STREAM_DEPTH   8192
+#define WEIGHT_STREAM_DEPTH  512
+#define OUTPUT_STREAM_DEPTH  512
+
+/* Fused early-layer FIFOs: one padded input row (416 beats) covers the
+ * row-at-a-time handoff between stages; parameter FIFOs are rate-matched. */
+#define FUSE_STREAM_DEPTH    512
+#define FUSE_PARAM_DEPTH     16
+
+/* =========================================================================
+ * STREAM TYPE & PROFILING HOOKS
+ *
+ * Synthesis / normal C-sim: plain hls::stream, hooks compile to an empty
+ * statement (so `else PROF_CYCLES(1);` still has a body).
+ * -DCONV_PROFILE: instrumented FIFO that records per-beat timestamps
+ * (see conv_profile.h).
+ * ========================================================================= */
+#ifdef CONV_PROFILE
+#include "conv_profile.h"
+typedef prof_stream<vec_t> vec_stream_t;
+#else
+typedef hls::stream<vec_t> vec_stream_t;
+#define PROF_STAGE(n)   ((void)0)
+#define PROF_CYCLES(n)  ((void)0)
+#endif
+
 /* =========================================================================
  * TOP-LEVEL PROTOTYPE
  * ========================================================================= */
@@ -81,12 +356,43 @@ extern "C" void conv_engine(
     wide_t* input_dram,
     wide_t* output_dram,
     wide_t* weights_dram,
-    data_t* bn_params_dram,
+    int*    ic_map_dram,
+    int*    oc_map_dram,
+    wide_t* residual_dram,
     int in_channels, int out_channels,
     int in_height,   int in_width,
-    int kernel_size,  int stride, int padding,
+    int kernel_size,  int stride,
+    int pad_top,      int pad_bottom,
+    int pad_left,     int pad_right,
     int use_pool,     int pool_stride,
-    int use_leaky
+    int pool_pad_bottom, int pool_pad_right,
+    int use_leaky,
+    int use_chan_map,
+    int wt_int8,
+    int fuse_early,
+    int in_act_shift,
+    int out_act_shift,
+    int use_upsample,
+    int use_add,
+    int oc_offset,
+    int total_out_channels,
+    int in_ic_offset,
+    int in_row_pitch,
+    int in_plane_pitch,
+    int in_row0,
+    int in_col0,
+    int groups,
+    int*    stats_dram,
+    wide_t* next_weights_dram,
+    int next_wt_blocks,
+    int next_wt_blk_words,
+    int next_wt_stride,
+    int wt_staged,
+    int job_tail,
+    int job_batch,
+    int job_queue[JOBQ_DEPTH * JOB_WORDS],
+    int*    jobs_done,
+    int*    job_empty
 );
 
 #endif /* CONV_ENGINE_V3_H */
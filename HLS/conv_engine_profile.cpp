@@ -0,0 +1,354 @@
+/**
+ * conv_engine_profile.cpp
+ * C-sim FIFO occupancy profiler for the Tiny-YOLO layer table
+ *
+ * Build (instrumented C-sim, never synthesized):
+ *   vitis-run --mode hls --tcl run_profile.tcl
+ * or directly:
+ *   g++ -O2 -DCONV_PROFILE -I$XILINX_HLS/include \
+ *       conv_engine.cpp conv_engine_profile.cpp -o conv_profile
+ *   ./conv_profile [--tol=PCT] [layer-name ...]   (default: all layers)
+ *
+ * For each layer and each DATAFLOW stream it reports:
+ *   beats      total 256-bit beats through the FIFO
+ *   hwm_inf    occupancy high-water mark with an unbounded FIFO
+ *   hwm_cfg    high-water mark at the configured depth
+ *   blk_rd     consumer reads that found the FIFO empty (count / cycles)
+ *   blk_wr     producer writes that would find the FIFO full at the
+ *              configured depth (count / cycles)
+ *   min_depth  smallest depth at which back-pressure never delays a beat
+ *              past the cycle the consumer asks for it (zero-stall bound)
+ *
+ * The depth estimate treats each stream in isolation: the consumer's read
+ * times come from the unbounded run, and a throttled producer keeps its
+ * own spacing between consecutive writes.
+ *
+ * The summary does not recommend min_depth: a few late beats in one large
+ * layer can demand a FIFO many times the configured one.  For every
+ * candidate depth it reports the worst slowdown over the layers — the
+ * latest a throttled beat reaches its consumer, relative to the layer's
+ * cycle count — and recommends the smallest depth within the stall
+ * tolerance (--tol, default STALL_TOL_PCT), rounded up while the next
+ * depth costs no more BRAM.  A recommendation above the
+ * configured depth is marked "grow" and not counted as BRAM freed.
+ */
+#include "conv_engine.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/* Acceptable layer slowdown from FIFO back-pressure, in percent */
+#define STALL_TOL_PCT 2.0
+
+/* Depths the summary evaluates (powers of two, 256-bit beats) */
+static const unsigned long long CAND_DEPTHS[] =
+    { 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768 };
+static const int N_CAND = sizeof(CAND_DEPTHS) / sizeof(CAND_DEPTHS[0]);
+
+/* Tiny-YOLO v2 hardware schedule (matches LAYERS in PL/tinyyolo_pynq.ipynb;
+ * conv6 pools stride 1 over ZeroPad2d(0,1,0,1) on the PL) */
+struct layer_cfg {
+    const char* name;
+    int ic, oc, ih, iw, k, s, p;
+    int use_pool, pool_stride, pool_pad;   /* pool_pad: bottom and right */
+    int use_leaky;
+    int fuse_early;             /* 1: conv1→conv3 in one fused invocation */
+    int chan_map;               /* 1: ic/oc are the ACTIVE channels of a
+                                 *    2× wider pruned layer (every 2nd plane) */
+    int wt_int8;                /* 1: W8A16, int8 weights on gmem2        */
+    int act_shift;              /* ≥0: ACT8 input and output maps          */
+    int upsample;               /* 1: 2× nearest upsample on write         */
+    int add;                    /* 1: add a residual map on write          */
+    int groups;                 /* >1: grouped; = ic = oc: depthwise       */
+};
+
+static const layer_cfg LAYERS[] = {
+    { "conv1",    3,   16, 416, 416, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv2",   16,   32, 208, 208, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv3",   32,   64, 104, 104, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv4",   64,  128,  52,  52, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv5",  128,  256,  26,  26, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv6",  256,  512,  13,  13, 3, 1, 1, 1, 1, 1,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv7",  512, 1024,  13,  13, 3, 1, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv8", 1024,  256,  13,  13, 1, 1, 0, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv9",  256,  512,  13,  13, 3, 1, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "det",    512,  425,  13,  13, 1, 1, 0, 0, 0, 0, -1, 0, 0, 0, -1,  0, 0, 1 },
+    /* conv1–conv3 fused: image in, pooled conv3 out (compare vs conv1+2+3) */
+    { "fused",    3,   64, 416, 416, 3, 1, 1, 1, 2, 0,  1, 1, 0, 0, -1,  0, 0, 1 },
+    /* conv5 pruned 50% in and out via channel remap (compare vs conv5) */
+    { "conv5p",  64,  128,  26,  26, 3, 1, 1, 1, 2, 0,  1, 0, 1, 0, -1,  0, 0, 1 },
+    /* W8A16 on the weight-bound 13×13 layers (compare vs conv7 / conv9) */
+    { "conv7w8", 512, 1024, 13,  13, 3, 1, 1, 0, 0, 0,  1, 0, 0, 1, -1,  0, 0, 1 },
+    { "conv9w8", 256,  512, 13,  13, 3, 1, 1, 0, 0, 0,  1, 0, 0, 1, -1,  0, 0, 1 },
+    /* ACT8 int8 inter-layer maps (compare vs conv4 / conv5) */
+    { "conv4a8",  64,  128, 52,  52, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0,  4,  0, 0, 1 },
+    { "conv5a8", 128,  256, 26,  26, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0,  4,  0, 0, 1 },
+    /* Tiny-YOLOv3 head: 1×1 → 2× upsample into the 26×26 route, and the
+     * same layer with a residual add (compare vs conv8) */
+    { "conv8up",  256, 128, 13,  13, 1, 1, 0, 0, 0, 0,  1, 0, 0, 0, -1,  1, 0, 1 },
+    { "conv8add",1024, 256, 13,  13, 1, 1, 0, 0, 0, 0,  1, 0, 0, 0, -1,  0, 1, 1 },
+    /* MobileNet-style separable block at conv4 scale: 3×3 depthwise, then
+     * 1×1 pointwise with the pool (compare dw4 + pw4 vs conv4), and conv5
+     * as 2 groups (compare vs conv5) */
+    { "dw4",      64,  64, 52,  52, 3, 1, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 64 },
+    { "pw4",      64, 128, 52,  52, 1, 1, 0, 1, 2, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv5g2", 128, 256, 26,  26, 3, 1, 1, 1, 2, 0,  1, 0, 0, 0, -1,  0, 0, 2 },
+    /* conv1–conv5 as stride-2 convs instead of conv + 2×2 pool: same
+     * output maps, 4× fewer MACs (compare vs conv1..conv5) */
+    { "conv1s2",  3,   16, 416, 416, 3, 2, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv2s2", 16,   32, 208, 208, 3, 2, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv3s2", 32,   64, 104, 104, 3, 2, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv4s2", 64,  128,  52,  52, 3, 2, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+    { "conv5s2",128,  256,  26,  26, 3, 2, 1, 0, 0, 0,  1, 0, 0, 0, -1,  0, 0, 1 },
+};
+static const int N_LAYERS = sizeof(LAYERS) / sizeof(LAYERS[0]);
+
+/* ---- Per-stream analysis result ---- */
+struct fifo_stats {
+    unsigned long long beats;
+    unsigned long long hwm_inf, hwm_cfg;
+    unsigned long long blk_rd;
+    prof_cycle_t       blk_rd_cycles;
+    unsigned long long blk_wr;
+    prof_cycle_t       blk_wr_cycles;
+    unsigned long long min_depth;
+};
+
+static int configured_depth(const string& name) {
+    if (name == "input_stream")  return INPUT_STREAM_DEPTH;
+    if (name == "weight_stream") return WEIGHT_STREAM_DEPTH;
+    if (name == "output_stream") return OUTPUT_STREAM_DEPTH;
+    if (name.compare(0, 8, "fuse_prm") == 0) return FUSE_PARAM_DEPTH;
+    if (name.compare(0, 5, "fuse_") == 0)    return FUSE_STREAM_DEPTH;
+    return 2;
+}
+
+/* Producer write schedule when limited to `depth` entries in flight:
+ * beat k cannot be written before beat k-depth has been read. */
+static void throttle(const prof_stream_rec& r, unsigned long long depth,
+                     vector<prof_cycle_t>& t_wr,
+                     unsigned long long* n_blk, prof_cycle_t* blk_cycles) {
+    size_t n = r.t_wr.size();
+    t_wr.resize(n);
+    if (n_blk)      *n_blk = 0;
+    if (blk_cycles) *blk_cycles = 0;
+    for (size_t k = 0; k < n; k++) {
+        prof_cycle_t t = (k == 0) ? r.t_wr[0]
+                                  : t_wr[k-1] + (r.t_wr[k] - r.t_wr[k-1]);
+        if (k >= depth) {
+            prof_cycle_t slot = r.t_rd[k - depth] + 1;
+            if (slot > t) {
+                if (n_blk)      (*n_blk)++;
+                if (blk_cycles) *blk_cycles += slot - t;
+                t = slot;
+            }
+        }
+        t_wr[k] = t;
+    }
+}
+
+/* Max number of beats resident in the FIFO at any write instant */
+static unsigned long long high_water(const vector<prof_cycle_t>& t_wr,
+                                     const vector<prof_cycle_t>& t_rd) {
+    unsigned long long hwm = 0;
+    size_t rd = 0;
+    for (size_t k = 0; k < t_wr.size(); k++) {
+        while (rd < t_rd.size() && t_rd[rd] < t_wr[k]) rd++;
+        /* a throttled write can land after its unbounded-run read time */
+        unsigned long long occ = (rd < k + 1) ? (k + 1) - rd : 0;
+        if (occ > hwm) hwm = occ;
+    }
+    return hwm;
+}
+
+/* Latest a beat arrives after its consumer read (0: every beat on time);
+ * the consumer, and everything downstream of it, slips by about this much */
+static prof_cycle_t late_cycles(const prof_stream_rec& r, unsigned long long depth) {
+    vector<prof_cycle_t> t_wr;
+    throttle(r, depth, t_wr, 0, 0);
+    prof_cycle_t late = 0;
+    for (size_t k = 0; k < t_wr.size(); k++)
+        if (t_wr[k] + 1 > r.t_rd[k] && t_wr[k] + 1 - r.t_rd[k] > late)
+            late = t_wr[k] + 1 - r.t_rd[k];
+    return late;
+}
+
+static fifo_stats analyze(const prof_stream_rec& r) {
+    fifo_stats st;
+    memset(&st, 0, sizeof(st));
+    st.beats         = r.t_wr.size();
+    st.blk_rd        = r.blk_rd;
+    st.blk_rd_cycles = r.blk_rd_cycles;
+    if (st.beats == 0 || r.t_rd.size() != r.t_wr.size()) return st;
+
+    st.hwm_inf = high_water(r.t_wr, r.t_rd);
+
+    vector<prof_cycle_t> t_cfg;
+    throttle(r, configured_depth(r.name), t_cfg, &st.blk_wr, &st.blk_wr_cycles);
+    st.hwm_cfg = high_water(t_cfg, r.t_rd);
+
+    /* Binary search: late_cycles() is monotone in depth */
+    unsigned long long lo = 1, hi = st.hwm_inf;
+    while (lo < hi) {
+        unsigned long long mid = (lo + hi) / 2;
+        if (late_cycles(r, mid) == 0) hi = mid;
+        else                 lo = mid + 1;
+    }
+    st.min_depth = lo;
+    return st;
+}
+
+/* BRAM18K cost of a 256-bit FIFO (best aspect ratio; small FIFOs → SRL) */
+static int fifo_bram18k(unsigned long long depth) {
+    if (depth <= 32) return 0;
+    static const int cfg_depth[] = { 512, 1024, 2048, 4096, 8192, 16384 };
+    static const int cfg_width[] = {  36,   18,    9,    4,    2,     1 };
+    int best = 1 << 30;
+    for (int c = 0; c < 6; c++) {
+        int cols = (256 + cfg_width[c] - 1) / cfg_width[c];
+        int rows = (int)((depth + cfg_depth[c] - 1) / cfg_depth[c]);
+        if (cols * rows < best) best = cols * rows;
+    }
+    return best;
+}
+
+static bool selected(const char* name, int argc, char** argv) {
+    bool any = false;
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--", 2) == 0) continue;
+        any = true;
+        if (strcmp(argv[a], name) == 0) return true;
+    }
+    return !any;
+}
+
+int main(int argc, char** argv) {
+    const char* stream_names[3] = { "input_stream", "weight_stream", "output_stream" };
+    unsigned long long worst[3] = { 0, 0, 0 };
+    double slow[3][N_CAND];          /* worst slowdown (%) over the layers */
+    const char* slow_at[3][N_CAND];  /* ... and the layer that sets it     */
+    for (int s = 0; s < 3; s++)
+        for (int c = 0; c < N_CAND; c++) { slow[s][c] = 0.0; slow_at[s][c] = "-"; }
+    double tol = STALL_TOL_PCT;
+    for (int a = 1; a < argc; a++)
+        if (strncmp(argv[a], "--tol=", 6) == 0) tol = atof(argv[a] + 6);
+
+    printf("FIFO occupancy profile (AXI read latency model: %d cycles)\n",
+           PROF_AXI_LATENCY);
+    printf("%-6s %-14s %9s %8s %8s %18s %18s %9s\n",
+           "layer", "stream", "beats", "hwm_inf", "hwm_cfg",
+           "blk_rd (n/cyc)", "blk_wr (n/cyc)", "min_depth");
+
+    for (int l = 0; l < N_LAYERS; l++) {
+        const layer_cfg& L = LAYERS[l];
+        if (!selected(L.name, argc, argv)) continue;
+
+        int oh = (L.ih + 2 * L.p - L.k) / L.s + 1;
+        int ow = (L.iw + 2 * L.p - L.k) / L.s + 1;
+        int fh = (L.use_pool && L.pool_stride >= 2) ? oh / 2 : oh;
+        int fw = (L.use_pool && L.pool_stride >= 2) ? ow / 2 : ow;
+        if (L.upsample) { fh *= 2; fw *= 2; }
+        /* pre-tiled weights: 16×16 channel tiles, 2 header words each */
+        size_t wt_elems = (size_t)(L.oc + 15) / 16 * ((L.ic + 15) / 16)
+                        * (WT_HDR_BEATS + TILE_OC * L.k * L.k) * 16;
+        if (L.fuse_early)
+            wt_elems = (size_t)(FUSE_C1 * FUSE_C0 + FUSE_C2 * FUSE_C1
+                              + FUSE_C3 * FUSE_C2) * 9
+                     + FUSE_C1 + FUSE_C2 + FUSE_C3;
+
+        /* Pruned layers keep every 2nd plane of a 2× wider map */
+        int planes = L.chan_map ? 2 : 1;
+        vector<int> ic_map(L.ic), oc_map(L.oc);
+        for (int c = 0; c < L.ic; c++) ic_map[c] = c * planes;
+        for (int c = 0; c < L.oc; c++) oc_map[c] = c * planes;
+
+        /* Data values do not affect timing: small deterministic pattern */
+        vector<wide_t> input_dram ((size_t)planes * L.ic * L.ih * L.iw / 16 + 256, 0);
+        vector<wide_t> output_dram((size_t)planes * L.oc * fh * fw / 16 + 256, 0);
+        vector<wide_t> weights_dram(wt_elems / 16 + 256, 0);
+        vector<wide_t> residual_dram(L.add ? output_dram.size() : 1, 0);
+        vector<int>    stats(STAT_WORDS, 0);
+        for (size_t i = 0; i < input_dram.size(); i++)
+            input_dram[i].range(15, 0) = (unsigned)(i & 0xFF);
+
+        prof_reset();
+        conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                    ic_map.data(), oc_map.data(), residual_dram.data(),
+                    L.ic, L.oc, L.ih, L.iw, L.k, L.s, L.p, L.p, L.p, L.p,
+                    L.use_pool, L.pool_stride, L.pool_pad, L.pool_pad,
+                    L.use_leaky, L.chan_map, L.wt_int8, L.fuse_early,
+                    L.act_shift, L.act_shift, L.upsample, L.add, 0, 0,
+                    0, 0, 0, 0, 0, L.groups, stats.data(),
+                    nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+        /* Layer length: DATAFLOW ends with its slowest process */
+        const vector<prof_stage_rec>& stages = prof_stages();
+        prof_cycle_t span = 1;
+        for (size_t s = 0; s < stages.size(); s++)
+            if (stages[s].cycles > span) span = stages[s].cycles;
+
+        const vector<prof_stream_rec>& recs = prof_streams();
+        for (size_t r = 0; r < recs.size(); r++) {
+            fifo_stats st = analyze(recs[r]);
+            char rd[32], wr[32];
+            snprintf(rd, sizeof(rd), "%llu/%llu", st.blk_rd, st.blk_rd_cycles);
+            snprintf(wr, sizeof(wr), "%llu/%llu", st.blk_wr, st.blk_wr_cycles);
+            printf("%-6s %-14s %9llu %8llu %8llu %18s %18s %9llu\n",
+                   L.name, recs[r].name.c_str(), st.beats, st.hwm_inf,
+                   st.hwm_cfg, rd, wr, st.min_depth);
+            for (int s = 0; s < 3; s++) {
+                if (recs[r].name != stream_names[s] || st.beats == 0) continue;
+                if (st.min_depth > worst[s]) worst[s] = st.min_depth;
+                for (int c = 0; c < N_CAND; c++) {
+                    double pct = 100.0 * late_cycles(recs[r], CAND_DEPTHS[c]) / span;
+                    if (pct > slow[s][c]) { slow[s][c] = pct; slow_at[s][c] = L.name; }
+                }
+            }
+        }
+
+        printf("%-6s stage cycles:", L.name);
+        for (size_t s = 0; s < stages.size(); s++)
+            printf("  %s=%llu", stages[s].name.c_str(), stages[s].cycles);
+        printf("\n");
+    }
+
+    printf("\n===== WORST-LAYER SLOWDOWN (%%) PER DEPTH =====\n");
+    printf("%-14s", "stream");
+    for (int c = 0; c < N_CAND; c++) printf(" %8llu", CAND_DEPTHS[c]);
+    printf("\n");
+    for (int s = 0; s < 3; s++) {
+        printf("%-14s", stream_names[s]);
+        for (int c = 0; c < N_CAND; c++) printf(" %8.2f", slow[s][c]);
+        printf("\n");
+    }
+
+    printf("\n===== RECOMMENDED DEPTHS (stall tolerance %.2f%%) =====\n", tol);
+    printf("%-14s %10s %8s %12s %8s %18s %10s\n", "stream", "configured",
+           "BRAM18K", "recommended", "BRAM18K", "slowdown (layer)", "zero-stall");
+    int bram_cfg = 0, bram_rec = 0;
+    for (int s = 0; s < 3; s++) {
+        int cfg = configured_depth(stream_names[s]);
+        int c = 0;
+        while (c < N_CAND - 1 && slow[s][c] > tol) c++;
+        /* Same BRAM at the next depth (256-bit width dominates): take it */
+        while (c < N_CAND - 1 && CAND_DEPTHS[c + 1] <= (unsigned long long)cfg
+               && fifo_bram18k(CAND_DEPTHS[c + 1]) == fifo_bram18k(CAND_DEPTHS[c]))
+            c++;
+        unsigned long long rec = CAND_DEPTHS[c];
+        bool grow = rec > (unsigned long long)cfg;
+        bram_cfg += fifo_bram18k(cfg);
+        bram_rec += grow ? fifo_bram18k(cfg) : fifo_bram18k(rec);
+        char sd[32];
+        snprintf(sd, sizeof(sd), "%.2f%% (%s)", slow[s][c], slow_at[s][c]);
+        printf("%-14s %10d %8d %12llu %8d %18s %10llu%s\n", stream_names[s],
+               cfg, fifo_bram18k(cfg), rec, fifo_bram18k(rec), sd,
+               worst[s], grow ? "  grow: above configured" : "");
+    }
+    printf("Total FIFO BRAM18K: %d configured -> %d recommended (%d freed; "
+           "growth not applied)\n", bram_cfg, bram_rec, bram_cfg - bram_rec);
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
 
 using namespace std;
 
@@ -19,6 +20,156 @@ data_t unpack_element(const wide_t* dram, int idx) {
     return val;
 }
 
+// ACT8 feature maps (shift ≥ 0): byte q holds data_t raw bits q << shift.
+// act8_round gives the value a map keeps after the round-half-up/saturate
+// pack; store_act/unpack_act address either format (shift < 0: 16-bit).
+data_t act8_round(data_t v, int shift) {
+    int raw = (ap_int<16>)v.range(15, 0);
+    int q = (raw + (shift > 0 ? 1 << (shift - 1) : 0)) >> shift;
+    q = q > 127 ? 127 : (q < -128 ? -128 : q);
+    data_t r;
+    r.range(15, 0) = (ap_int<16>)(q << shift);
+    return r;
+}
+
+void store_act(wide_t* dram, int idx, data_t v, int shift) {
+    if (shift < 0) {
+        dram[idx/16].range((idx%16)*16+15, (idx%16)*16) = v.range(15, 0);
+    } else {
+        int raw = (ap_int<16>)act8_round(v, shift).range(15, 0);
+        dram[idx/32].range((idx%32)*8+7, (idx%32)*8) = (ap_int<8>)(raw >> shift);
+    }
+}
+
+data_t unpack_act(const wide_t* dram, int idx, int shift) {
+    if (shift < 0) return unpack_element(dram, idx);
+    ap_int<8> q = dram[idx/32].range((idx%32)*8+7, (idx%32)*8);
+    data_t v;
+    v.range(15, 0) = (ap_int<16>)(((ap_int<16>)q) << shift);
+    return v;
+}
+
+// Expected activation statistics (STAT_* block) of a map's values before
+// the output pack; compares against what the engine wrote and prints the
+// mismatching words.  Returns the number of mismatches.
+int check_stats(const int* hw, const std::vector<data_t>& vals, int shift) {
+    int exp[STAT_WORDS] = { 32767, -32768, 0, 0 };
+    for (int b = 0; b < STAT_BINS; b++) exp[STAT_HIST + b] = 0;
+    for (size_t i = 0; i < vals.size(); i++) {
+        int raw = (ap_int<16>)vals[i].range(15, 0);
+        exp[STAT_MIN] = std::min(exp[STAT_MIN], raw);
+        exp[STAT_MAX] = std::max(exp[STAT_MAX], raw);
+        int q = (shift < 0) ? 0 : (raw + (shift > 0 ? 1 << (shift - 1) : 0)) >> shift;
+        bool clip = (shift < 0) ? (raw == 32767 || raw == -32768)
+                                : (q > 127 || q < -128);
+        exp[STAT_SAT] += clip;
+        exp[STAT_COUNT]++;
+        int mag = std::abs(raw), bin = 0;
+        while (bin < STAT_BINS - 1 && mag >= (1 << bin)) bin++;
+        exp[STAT_HIST + bin]++;
+    }
+    int err = 0;
+    for (int k = 0; k < STAT_WORDS; k++) {
+        if (hw[k] != exp[k]) {
+            if (err < 5) printf("  Stats word %d: HW=%d SW=%d\n", k, hw[k], exp[k]);
+            err++;
+        }
+    }
+    printf("  Stats: range [%.4f, %.4f]  clipped %d/%d\n",
+           hw[STAT_MIN] / 256.0, hw[STAT_MAX] / 256.0, hw[STAT_SAT], hw[STAT_COUNT]);
+    return err;
+}
+
+// Per-OC scale header word { m[10:0], e[4:0] } = (1 + m/2048)·2^e
+// (m = 0 and scale rounded to a power of two unless WT8_SCALE_MANT)
+int scale_word(float scale)
+{
+#if WT8_SCALE_MANT
+    int e = (int)std::floor(std::log2(scale));
+    int m = (int)std::lround((std::ldexp(scale, -e) - 1.0f) * 2048.0f);
+    if (m == 2048) { m = 0; e++; }
+    return (m << 5) | (e & 31);
+#else
+    return (int)std::lround(std::log2(scale)) & 31;
+#endif
+}
+
+// Host-side weight export: OIHW → pre-tiled blocks
+//   [oc_tile][ic_tile][ bias[16] | scale[16] | oc ][ky][kx][ic]
+// zero-padded to 16×16 channel tiles (one 256-bit word per stream beat).
+// Weights are taken as already BN-folded; the [scale, bias] pairs give the
+// bias header and the scale header (the W8A16 dequant step, any positive
+// value; 16-bit layers fold everything into the weights and pass 1).
+// wt_int8=1 packs int8 bytes q = value·128 instead of 16-bit data_t.
+void pack_weights_tiled(const std::vector<data_t>& weight_flat,
+                        const std::vector<data_t>& bn_params,
+                        std::vector<wide_t>& weights_dram,
+                        int OC, int IC, int K, int wt_int8)
+{
+    int to_steps = (OC + TILE_OC - 1) / TILE_OC;
+    int ti_steps = (IC + TILE_IC - 1) / TILE_IC;
+    int w = 0;                               // word index in DRAM order
+    for (int to = 0; to < to_steps; to++)
+      for (int ti = 0; ti < ti_steps; ti++) {
+        for (int o = 0; o < TILE_OC; o++) {
+            int oc = to * TILE_OC + o;
+            data_t bias  = (oc < OC) ? bn_params[oc*2 + 1] : (data_t)0;
+            int    scl   = (oc < OC) ? scale_word((float)bn_params[oc*2]) : 0;
+            weights_dram[w].range(o*16+15, o*16)     = bias.range(15, 0);
+            weights_dram[w + 1].range(o*16+15, o*16) = scl;
+        }
+        w += WT_HDR_BEATS;
+        int e = 0;                           // element index within block
+        for (int o = 0; o < TILE_OC; o++)
+          for (int ky = 0; ky < K; ky++)
+            for (int kx = 0; kx < K; kx++)
+              for (int i = 0; i < TILE_IC; i++, e++) {
+                  int oc = to * TILE_OC + o, ic = ti * TILE_IC + i;
+                  data_t v = (oc < OC && ic < IC)
+                           ? weight_flat[((oc * IC + ic) * K + ky) * K + kx] : (data_t)0;
+                  if (wt_int8)
+                      weights_dram[w + e / 32].range((e % 32)*8+7, (e % 32)*8) = v.range(8, 1);
+                  else
+                      weights_dram[w + e / 16].range((e % 16)*16+15, (e % 16)*16) = v.range(15, 0);
+              }
+        w += wt_int8 ? e / 32 : e / 16;
+      }
+}
+
+// Depthwise export: [C][1][K][K] → one block per 16-channel tile,
+//   [ bias[16] | scale[16] | ky ][kx][c]
+// (K² beats, lane = channel; an int8 block pads its odd last half-word).
+void pack_weights_dw(const std::vector<data_t>& weight_flat,
+                     const std::vector<data_t>& bn_params,
+                     std::vector<wide_t>& weights_dram,
+                     int C, int K, int wt_int8)
+{
+    int t_steps = (C + TILE_OC - 1) / TILE_OC;
+    int w = 0;
+    for (int t = 0; t < t_steps; t++) {
+        for (int o = 0; o < TILE_OC; o++) {
+            int c = t * TILE_OC + o;
+            data_t bias  = (c < C) ? bn_params[c*2 + 1] : (data_t)0;
+            int    scl   = (c < C) ? scale_word((float)bn_params[c*2]) : 0;
+            weights_dram[w].range(o*16+15, o*16)     = bias.range(15, 0);
+            weights_dram[w + 1].range(o*16+15, o*16) = scl;
+        }
+        w += WT_HDR_BEATS;
+        int e = 0;
+        for (int ky = 0; ky < K; ky++)
+          for (int kx = 0; kx < K; kx++)
+            for (int o = 0; o < TILE_OC; o++, e++) {
+                int c = t * TILE_OC + o;
+                data_t v = (c < C) ? weight_flat[(c * K + ky) * K + kx] : (data_t)0;
+                if (wt_int8)
+                    weights_dram[w + e / 32].range((e % 32)*8+7, (e % 32)*8) = v.range(8, 1);
+                else
+                    weights_dram[w + e / 16].range((e % 16)*16+15, (e % 16)*16) = v.range(15, 0);
+            }
+        w += wt_int8 ? (e + 31) / 32 : e / 16;
+    }
+}
+
 // Golden Reference (Slow but accurate fixed-point emulation)
 void conv_golden(
     const std::vector<data_t>& input_flat,
@@ -27,7 +178,7 @@ void conv_golden(
     const std::vector<data_t>& bn_params,
     int in_channels, int out_channels,
     int in_height, int in_width,
-    int kernel_size, int stride, int padding,
+    int kernel_size, int stride, int pad_top, int pad_left,
     int out_height, int out_width,
     int use_leaky
 ) {
@@ -39,8 +190,8 @@ void conv_golden(
             for (int ow = 0; ow < out_width; ow++) {
                 
                 acc_t sum = 0;
-                int h_start = oh * stride - padding;
-                int w_start = ow * stride - padding;
+                int h_start = oh * stride - pad_top;
+                int w_start = ow * stride - pad_left;
 
                 for (int ic = 0; ic < in_channels; ic++) {
                     for (int ky = 0; ky < kernel_size; ky++) {
@@ -79,21 +230,27 @@ void conv_golden(
     }
 }
 
-// Golden reference for max-pool (2x2 stride 2, matches HW)
+// Golden reference for max-pool (2x2, stride 2 or 1, matches HW).
+// pad_b/pad_r append zero rows/cols first (nn.ZeroPad2d semantics).
 void pool_golden(
     const std::vector<data_t>& input_flat,
     std::vector<data_t>& output_flat,
-    int channels, int in_h, int in_w
+    int channels, int in_h, int in_w,
+    int stride = 2, int pad_b = 0, int pad_r = 0
 ) {
-    int out_h = in_h / 2;
-    int out_w = in_w / 2;
+    int out_h = (in_h + pad_b - 2) / stride + 1;
+    int out_w = (in_w + pad_r - 2) / stride + 1;
     for (int c = 0; c < channels; c++) {
         for (int oh = 0; oh < out_h; oh++) {
             for (int ow = 0; ow < out_w; ow++) {
-                data_t v0 = input_flat[(c * in_h + oh*2  ) * in_w + ow*2  ];
-                data_t v1 = input_flat[(c * in_h + oh*2+1) * in_w + ow*2  ];
-                data_t v2 = input_flat[(c * in_h + oh*2  ) * in_w + ow*2+1];
-                data_t v3 = input_flat[(c * in_h + oh*2+1) * in_w + ow*2+1];
+                data_t v[4];
+                for (int d = 0; d < 4; d++) {
+                    int y = oh * stride + (d & 1);
+                    int x = ow * stride + (d >> 1);
+                    v[d] = (y < in_h && x < in_w) ? input_flat[(c * in_h + y) * in_w + x]
+                                                  : (data_t)0;
+                }
+                data_t v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
                 data_t mx01 = (v0 > v1) ? v0 : v1;
                 data_t mx23 = (v2 > v3) ? v2 : v3;
                 output_flat[(c * out_h + oh) * out_w + ow] = (mx01 > mx23) ? mx01 : mx23;
@@ -102,30 +259,43 @@ void pool_golden(
     }
 }
 
-// Run a single test configuration. Returns 0 on pass, 1 on fail.
-int run_test(const char* name,
-             int IC, int OC, int H, int W, int K, int S, int P,
-             int use_pool, int pool_stride, int use_leaky)
+// Run a single test configuration with per-side conv padding (top, bottom,
+// left, right) and pool padding (bottom, right). wt_int8=1 stores the
+// weights as int8 (W8A16; the engine reads byte q as q/128).  in_shift /
+// out_shift ≥ 0 keep the input / output map as ACT8 (int8, that shift).
+// upsample=1 expects a 2× nearest-upsampled output; use_add=1 adds a
+// residual map (output layout and format) on write.
+// Returns 0 on pass, 1 on fail.
+int run_test_pad(const char* name,
+                 int IC, int OC, int H, int W, int K, int S,
+                 int PT, int PB, int PL, int PR,
+                 int use_pool, int pool_stride, int PPB, int PPR, int use_leaky,
+                 int wt_int8 = 0, int in_shift = -1, int out_shift = -1,
+                 int upsample = 0, int use_add = 0)
 {
-    int OH = (H + 2*P - K)/S + 1;
-    int OW = (W + 2*P - K)/S + 1;
-    int final_h = use_pool ? OH / 2 : OH;
-    int final_w = use_pool ? OW / 2 : OW;
+    int OH = (H + PT + PB - K)/S + 1;
+    int OW = (W + PL + PR - K)/S + 1;
+    int PS = (pool_stride >= 2) ? 2 : 1;
+    int UP = upsample ? 2 : 1;
+    int final_h = (use_pool ? (OH + PPB - 2) / PS + 1 : OH) * UP;
+    int final_w = (use_pool ? (OW + PPR - 2) / PS + 1 : OW) * UP;
 
     printf("\n===== Test: %s =====\n", name);
-    printf("  IC=%d OC=%d H=%d W=%d K=%d S=%d P=%d pool=%d leaky=%d\n",
-           IC, OC, H, W, K, S, P, use_pool, use_leaky);
+    printf("  IC=%d OC=%d H=%d W=%d K=%d S=%d P=(%d,%d,%d,%d) pool=%d/%d pad=(%d,%d) leaky=%d w8=%d act8=%d/%d up=%d add=%d\n",
+           IC, OC, H, W, K, S, PT, PB, PL, PR, use_pool, PS, PPB, PPR, use_leaky, wt_int8,
+           in_shift, out_shift, upsample, use_add);
     printf("  Conv output: %dx%d  Final output: %dx%d\n", OH, OW, final_h, final_w);
 
     // Allocate DRAM arrays (wide words + generous padding)
     int in_size_words  = (IC * H * W) / 16 + 256;
-    int wt_size_words  = (OC * IC * K * K) / 16 + 256;
+    int wt_size_words  = (OC + 15) / 16 * ((IC + 15) / 16) * (WT_HDR_BEATS + 16 * K * K) + 256;
     int out_size_words = (OC * final_h * final_w) / 16 + 256;
 
     std::vector<wide_t> input_dram(in_size_words, 0);
     std::vector<wide_t> weights_dram(wt_size_words, 0);
     std::vector<wide_t> output_dram(out_size_words, 0);
-    std::vector<data_t> bn_dram(OC * 2 + 64, 0);
+    std::vector<wide_t> residual_dram(out_size_words, 0);
+    std::vector<data_t> bn_params(OC * 2 + 64, 0);
 
     // Flat buffers for golden reference
     std::vector<data_t> input_flat(IC * H * W);
@@ -136,48 +306,81 @@ int run_test(const char* name,
     // Initialize inputs (deterministic pattern)
     for (int i = 0; i < IC * H * W; i++) {
         data_t val = (float)(i % 100) / 100.0f;
+        if (in_shift >= 0) val = act8_round(val, in_shift);
         input_flat[i] = val;
-        int word_idx = i / 16;
-        int sub_idx  = i % 16;
-        input_dram[word_idx].range(sub_idx*16+15, sub_idx*16) = val.range(15, 0);
+        store_act(input_dram.data(), i, val, in_shift);
     }
 
     // Initialize weights
     for (int i = 0; i < OC * IC * K * K; i++) {
-        data_t val = (float)((i % 7) - 3) / 10.0f; // range -0.3 to +0.3
-        weight_flat[i] = val;
-        int word_idx = i / 16;
-        int sub_idx  = i % 16;
-        weights_dram[word_idx].range(sub_idx*16+15, sub_idx*16) = val.range(15, 0);
+        if (wt_int8)
+            weight_flat[i] = (float)((i * 37) % 255 - 127) / 128.0f; // full int8 range
+        else
+            weight_flat[i] = (float)((i % 7) - 3) / 10.0f; // range -0.3 to +0.3
     }
 
-    // Initialize BN params
+    // Initialize BN params (W8A16: per-OC dequant scale, with a mantissa
+    // when the build carries one)
     for (int i = 0; i < OC; i++) {
-        bn_dram[i*2]     = 1.0; // Scale
-        bn_dram[i*2 + 1] = 0.5; // Bias
+        bn_params[i*2]     = wt_int8 ? std::ldexp(1.0f + (WT8_SCALE_MANT ? (i % 3) * 0.3125f : 0.0f),
+                                                  i % 4 - 3) : 1.0f; // Scale
+        bn_params[i*2 + 1] = 0.5; // Bias
+    }
+    pack_weights_tiled(weight_flat, bn_params, weights_dram, OC, IC, K, wt_int8);
+
+    // Residual map: signed pattern in the output's own format
+    std::vector<data_t> residual_flat(OC * final_h * final_w, 0);
+    if (use_add) {
+        for (int i = 0; i < OC * final_h * final_w; i++) {
+            data_t val = (float)((i * 13) % 41 - 20) / 8.0f;
+            if (out_shift >= 0) val = act8_round(val, out_shift);
+            residual_flat[i] = val;
+            store_act(residual_dram.data(), i, val, out_shift);
+        }
     }
 
-    // Run hardware
-    conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(), bn_dram.data(),
-                IC, OC, H, W, K, S, P, use_pool, pool_stride, use_leaky);
+    // Run hardware (stats block poisoned: every word must be rewritten)
+    std::vector<int> stats(STAT_WORDS, 0x5A5A5A5A);
+    conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                nullptr, nullptr, residual_dram.data(),
+                IC, OC, H, W, K, S, PT, PB, PL, PR,
+                use_pool, pool_stride, PPB, PPR, use_leaky, 0, wt_int8, 0,
+                in_shift, out_shift, upsample, use_add, 0, 0,
+                0, 0, 0, 0, 0, 0, stats.data(),
+                nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
 
     // Run golden reference
-    conv_golden(input_flat, conv_out_flat, weight_flat, bn_dram,
-                IC, OC, H, W, K, S, P, OH, OW, use_leaky);
+    conv_golden(input_flat, conv_out_flat, weight_flat, bn_params,
+                IC, OC, H, W, K, S, PT, PL, OH, OW, use_leaky);
 
     if (use_pool) {
-        pool_golden(conv_out_flat, golden_flat, OC, OH, OW);
+        pool_golden(conv_out_flat, golden_flat, OC, OH, OW, PS, PPB, PPR);
     } else {
         golden_flat = conv_out_flat;
     }
+    if (upsample) {
+        std::vector<data_t> small = golden_flat;
+        int sh = final_h / 2, sw = final_w / 2;
+        golden_flat.resize(OC * final_h * final_w);
+        for (int c = 0; c < OC; c++)
+            for (int y = 0; y < final_h; y++)
+                for (int x = 0; x < final_w; x++)
+                    golden_flat[(c * final_h + y) * final_w + x] =
+                        small[(c * sh + y / 2) * sw + x / 2];
+    }
+    if (use_add) {
+        for (int i = 0; i < OC * final_h * final_w; i++)
+            golden_flat[i] = (data_t)(golden_flat[i] + residual_flat[i]);
+    }
 
     // Compare
     int err_count = 0;
     float max_err = 0.0f;
     int total_elements = OC * final_h * final_w;
     for (int i = 0; i < total_elements; i++) {
-        data_t hw_val = unpack_element(output_dram.data(), i);
-        data_t sw_val = golden_flat[i];
+        data_t hw_val = unpack_act(output_dram.data(), i, out_shift);
+        data_t sw_val = (out_shift >= 0) ? act8_round(golden_flat[i], out_shift)
+                                         : golden_flat[i];
         float diff = std::abs((float)hw_val - (float)sw_val);
         if (diff > 0.05f) {
             if (err_count < 10) {
@@ -192,6 +395,114 @@ int run_test(const char* name,
         }
         if (diff > max_err) max_err = diff;
     }
+    err_count += check_stats(stats.data(), golden_flat, out_shift);
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements, max_err=%.6f)\n", total_elements, max_err);
+        return 0;
+    } else {
+        printf("  FAILED! %d/%d errors, max_err=%.6f\n", err_count, total_elements, max_err);
+        return 1;
+    }
+}
+
+// Symmetric padding, no pool padding
+int run_test(const char* name,
+             int IC, int OC, int H, int W, int K, int S, int P,
+             int use_pool, int pool_stride, int use_leaky)
+{
+    return run_test_pad(name, IC, OC, H, W, K, S, P, P, P, P,
+                        use_pool, pool_stride, 0, 0, use_leaky);
+}
+
+// Fused conv1→conv3 mode: three 3x3/s1/p1 conv+pool layers in one call.
+// Golden = the same three layers run one by one through conv/pool_golden.
+// border > 0 stores the image as a crop of a frame with that many junk
+// rows/cols on every side (input view: row/plane pitch + origin).
+int run_fused_test(const char* name, int H, int W, int border = 0)
+{
+    const int C[4] = { FUSE_C0, FUSE_C1, FUSE_C2, FUSE_C3 };
+    int OH = H / 8, OW = W / 8;
+    int FH = H + 2 * border, FW = W + 2 * border;
+
+    printf("\n===== Test: %s =====\n", name);
+    printf("  fused conv1-conv3  in %dx%dx%d  out %dx%dx%d  border=%d\n",
+           C[0], H, W, C[3], OH, OW, border);
+
+    std::vector<wide_t> input_dram((C[0] * FH * FW) / 16 + 256, 0);
+    std::vector<wide_t> output_dram((C[3] * OH * OW) / 16 + 256, 0);
+    std::vector<wide_t> weights_dram(2048, 0);
+
+    data_t junk = -6.0;
+    for (int i = 0; i < C[0] * FH * FW; i++)
+        input_dram[i / 16].range((i % 16)*16+15, (i % 16)*16) = junk.range(15, 0);
+
+    std::vector<data_t> act(C[0] * H * W);
+    for (int i = 0; i < C[0] * H * W; i++) {
+        data_t val = (float)(i % 100) / 100.0f;
+        act[i] = val;
+        int c = i / (H * W), y = i / W % H, x = i % W;
+        int e = (c * FH + y + border) * FW + x + border;
+        input_dram[e / 16].range((e % 16)*16+15, (e % 16)*16) = val.range(15, 0);
+    }
+
+    // Per layer: COUT/16 bias words, then OIHW weights (BN scale 1, i.e.
+    // already folded) padded to a whole word.
+    std::vector<data_t> weight_flat[3], bn_flat[3];
+    int wt_base = 0;
+    for (int l = 0; l < 3; l++) {
+        bn_flat[l].resize(2 * C[l+1]);
+        for (int oc = 0; oc < C[l+1]; oc++) {
+            bn_flat[l][oc*2]     = 1.0;
+            bn_flat[l][oc*2 + 1] = (float)((oc % 5) - 2) / 8.0f;
+            int e = wt_base + oc;
+            weights_dram[e / 16].range((e % 16)*16+15, (e % 16)*16) =
+                bn_flat[l][oc*2 + 1].range(15, 0);
+        }
+        wt_base += C[l+1];
+
+        int n = C[l+1] * C[l] * 9;
+        weight_flat[l].resize(n);
+        for (int i = 0; i < n; i++) {
+            data_t val = (float)(((i + l) % 7) - 3) / 20.0f;
+            weight_flat[l][i] = val;
+            int e = wt_base + i;
+            weights_dram[e / 16].range((e % 16)*16+15, (e % 16)*16) = val.range(15, 0);
+        }
+        wt_base += (n + 15) / 16 * 16;
+    }
+
+    conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                nullptr, nullptr, nullptr,
+                C[0], C[3], H, W, 3, 1, 1, 1, 1, 1, 1, 2, 0, 0, 1, 0, 0, 1, -1, -1, 0, 0, 0, 0,
+                0, border ? FW : 0, border ? FH * FW : 0, border, border, 0, nullptr,
+                nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+    int h = H, w = W;
+    for (int l = 0; l < 3; l++) {
+        std::vector<data_t> conv_out(C[l+1] * h * w);
+        std::vector<data_t> pooled(C[l+1] * (h/2) * (w/2));
+        conv_golden(act, conv_out, weight_flat[l], bn_flat[l],
+                    C[l], C[l+1], h, w, 3, 1, 1, 1, h, w, 1);
+        pool_golden(conv_out, pooled, C[l+1], h, w);
+        act = pooled;
+        h /= 2; w /= 2;
+    }
+
+    int err_count = 0;
+    float max_err = 0.0f;
+    int total_elements = C[3] * OH * OW;
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_element(output_dram.data(), i);
+        float diff = std::abs((float)hw_val - (float)act[i]);
+        if (diff > 0.05f) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d: HW=%f SW=%f diff=%f\n",
+                       i, (float)hw_val, (float)act[i], diff);
+            err_count++;
+        }
+        if (diff > max_err) max_err = diff;
+    }
 
     if (err_count == 0) {
         printf("  PASSED! (%d elements, max_err=%.6f)\n", total_elements, max_err);
@@ -202,6 +513,636 @@ int run_test(const char* name,
     }
 }
 
+// Route/concat without a copy: two layers (OC_A and OC_B output channels,
+// different weights) write planes [0, OC_A) and [OC_A, OC_A+OC_B) of one
+// total-plane buffer via oc_offset / total_out_channels.  Plane ends are
+// not word-aligned, so the layers share a word at the seam; planes past
+// the concat must keep their sentinel value.
+int run_concat_test(const char* name, int IC, int OC_A, int OC_B, int H, int W)
+{
+    const int K = 3;
+    const int OC[2] = { OC_A, OC_B };
+    int total = OC_A + OC_B + 1;
+
+    printf("\n===== Test: %s =====\n", name);
+    printf("  IC=%d OC=%d+%d into %d planes  %dx%d\n", IC, OC_A, OC_B, total, H, W);
+
+    std::vector<wide_t> input_dram((IC * H * W) / 16 + 256, 0);
+    std::vector<wide_t> output_dram((total * H * W) / 16 + 256, 0);
+    std::vector<data_t> input_flat(IC * H * W);
+    std::vector<data_t> golden(total * H * W, 0);
+
+    data_t sentinel = 7.5;
+    for (int i = 0; i < total * H * W; i++) {
+        output_dram[i / 16].range((i % 16)*16+15, (i % 16)*16) = sentinel.range(15, 0);
+        golden[i] = sentinel;
+    }
+    for (int i = 0; i < IC * H * W; i++) {
+        data_t val = (float)(i % 100) / 100.0f;
+        input_flat[i] = val;
+        input_dram[i / 16].range((i % 16)*16+15, (i % 16)*16) = val.range(15, 0);
+    }
+
+    int offset = 0;
+    for (int l = 0; l < 2; l++) {
+        std::vector<wide_t> weights_dram((OC[l] + 15) / 16 * ((IC + 15) / 16) * (WT_HDR_BEATS + 16 * K * K) + 256, 0);
+        std::vector<data_t> weight_flat(OC[l] * IC * K * K);
+        std::vector<data_t> bn_params(OC[l] * 2, 0);
+        for (int i = 0; i < OC[l] * IC * K * K; i++)
+            weight_flat[i] = (float)(((i + 3 * l) % 7) - 3) / 10.0f;
+        for (int o = 0; o < OC[l]; o++) {
+            bn_params[o*2]     = 1.0;
+            bn_params[o*2 + 1] = (float)((o % 5) - 2 + l) / 8.0f;
+        }
+        pack_weights_tiled(weight_flat, bn_params, weights_dram, OC[l], IC, K, 0);
+
+        int stats[STAT_WORDS];
+        conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                    nullptr, nullptr, nullptr,
+                    IC, OC[l], H, W, K, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0, -1, -1, 0, 0,
+                    offset, total, 0, 0, 0, 0, 0, 0, stats,
+                    nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+        std::vector<data_t> conv_out(OC[l] * H * W);
+        conv_golden(input_flat, conv_out, weight_flat, bn_params,
+                    IC, OC[l], H, W, K, 1, 1, 1, H, W, 1);
+        for (int i = 0; i < OC[l] * H * W; i++)
+            golden[offset * H * W + i] = conv_out[i];
+        offset += OC[l];
+    }
+
+    int err_count = 0;
+    float max_err = 0.0f;
+    int total_elements = total * H * W;
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_element(output_dram.data(), i);
+        float diff = std::abs((float)hw_val - (float)golden[i]);
+        if (diff > 0.05f) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d (plane=%d): HW=%f SW=%f diff=%f\n",
+                       i, i / (H * W), (float)hw_val, (float)golden[i], diff);
+            err_count++;
+        }
+        if (diff > max_err) max_err = diff;
+    }
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements, max_err=%.6f)\n", total_elements, max_err);
+        return 0;
+    } else {
+        printf("  FAILED! %d/%d errors, max_err=%.6f\n", err_count, total_elements, max_err);
+        return 1;
+    }
+}
+
+// Input view: the IC × H × W input is a window of a BC × BH × BW frame,
+// starting at plane ic0, row r0, column c0, and is read in place through
+// in_ic_offset / row and plane pitch / origin.  Every element outside the
+// window holds a large junk value, so any stray read shows up in the
+// output.  Golden = the same layer on a dense copy of the window.
+int run_view_test(const char* name, int IC, int OC, int H, int W,
+                  int BC, int BH, int BW, int ic0, int r0, int c0,
+                  int in_shift = -1)
+{
+    const int K = 3;
+
+    printf("\n===== Test: %s =====\n", name);
+    printf("  IC=%d OC=%d %dx%d window at (c=%d, y=%d, x=%d) of %dx%dx%d act8=%d\n",
+           IC, OC, H, W, ic0, r0, c0, BC, BH, BW, in_shift);
+
+    std::vector<wide_t> input_dram((BC * BH * BW) / 16 + 256, 0);
+    std::vector<wide_t> weights_dram((OC + 15) / 16 * ((IC + 15) / 16) * (WT_HDR_BEATS + 16 * K * K) + 256, 0);
+    std::vector<wide_t> output_dram((OC * H * W) / 16 + 256, 0);
+    std::vector<data_t> input_flat(IC * H * W);
+    std::vector<data_t> weight_flat(OC * IC * K * K);
+    std::vector<data_t> bn_params(OC * 2, 0);
+    std::vector<data_t> golden(OC * H * W);
+
+    for (int i = 0; i < BC * BH * BW; i++) {
+        int c = i / (BH * BW), y = i / BW % BH, x = i % BW;
+        data_t val = -4.0;
+        if (c >= ic0 && c < ic0 + IC && y >= r0 && y < r0 + H && x >= c0 && x < c0 + W) {
+            int e = ((c - ic0) * H + y - r0) * W + x - c0;
+            val = (float)(e % 100) / 100.0f;
+            if (in_shift >= 0) val = act8_round(val, in_shift);
+            input_flat[e] = val;
+        }
+        store_act(input_dram.data(), i, val, in_shift);
+    }
+    for (int i = 0; i < OC * IC * K * K; i++)
+        weight_flat[i] = (float)((i % 7) - 3) / 10.0f;
+    for (int o = 0; o < OC; o++) {
+        bn_params[o*2]     = 1.0;
+        bn_params[o*2 + 1] = 0.5;
+    }
+    pack_weights_tiled(weight_flat, bn_params, weights_dram, OC, IC, K, 0);
+
+    int stats[STAT_WORDS];
+    conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                nullptr, nullptr, nullptr,
+                IC, OC, H, W, K, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0,
+                in_shift, -1, 0, 0, 0, 0,
+                ic0, BW, BH * BW, r0, c0, 0, stats,
+                nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+    conv_golden(input_flat, golden, weight_flat, bn_params,
+                IC, OC, H, W, K, 1, 1, 1, H, W, 1);
+
+    int err_count = 0;
+    float max_err = 0.0f;
+    int total_elements = OC * H * W;
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_element(output_dram.data(), i);
+        float diff = std::abs((float)hw_val - (float)golden[i]);
+        if (diff > 0.05f) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d (oc=%d): HW=%f SW=%f diff=%f\n",
+                       i, i / (H * W), (float)hw_val, (float)golden[i], diff);
+            err_count++;
+        }
+        if (diff > max_err) max_err = diff;
+    }
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements, max_err=%.6f)\n", total_elements, max_err);
+        return 0;
+    } else {
+        printf("  FAILED! %d/%d errors, max_err=%.6f\n", err_count, total_elements, max_err);
+        return 1;
+    }
+}
+
+// Grouped / depthwise conv (groups = G): weights are the [OC][IC/G][K][K]
+// tensor, exported tile-aligned (pack_weights_tiled over IC/G) or, for
+// G = IC = OC, as depthwise blocks.  Golden = the dense conv on the
+// block-diagonal expansion of the same weights.  "Same" padding, optional
+// 2×2/s2 pool.
+int run_grouped_test(const char* name, int IC, int OC, int G, int H, int W,
+                     int K, int S, int use_pool, int wt_int8 = 0)
+{
+    int P   = K / 2;
+    int ICG = IC / G, OCG = OC / G;
+    bool dw = (G == IC);
+    int OH = (H + 2 * P - K) / S + 1;
+    int OW = (W + 2 * P - K) / S + 1;
+    int FH = use_pool ? OH / 2 : OH;
+    int FW = use_pool ? OW / 2 : OW;
+
+    printf("\n===== Test: %s =====\n", name);
+    printf("  IC=%d OC=%d groups=%d%s H=%d W=%d K=%d S=%d pool=%d w8=%d  out %dx%d\n",
+           IC, OC, G, dw ? " (depthwise)" : "", H, W, K, S, use_pool, wt_int8, FH, FW);
+
+    std::vector<wide_t> input_dram((IC * H * W) / 16 + 256, 0);
+    std::vector<wide_t> weights_dram((OC + 15) / 16 * ((ICG + 15) / 16) * (WT_HDR_BEATS + 16 * K * K) + 256, 0);
+    std::vector<wide_t> output_dram((OC * FH * FW) / 16 + 256, 0);
+    std::vector<data_t> input_flat(IC * H * W);
+    std::vector<data_t> weight_grp(OC * ICG * K * K);
+    std::vector<data_t> weight_flat(OC * IC * K * K, 0);
+    std::vector<data_t> bn_params(OC * 2, 0);
+    std::vector<data_t> conv_out(OC * OH * OW);
+    std::vector<data_t> golden(OC * FH * FW);
+
+    for (int i = 0; i < IC * H * W; i++) {
+        data_t val = (float)(i % 100) / 100.0f;
+        input_flat[i] = val;
+        input_dram[i / 16].range((i % 16)*16+15, (i % 16)*16) = val.range(15, 0);
+    }
+    for (int i = 0; i < OC * ICG * K * K; i++) {
+        if (wt_int8)
+            weight_grp[i] = (float)((i * 37) % 255 - 127) / 128.0f;
+        else
+            weight_grp[i] = (float)((i % 7) - 3) / 10.0f;
+        int oc = i / (ICG * K * K), r = i % (ICG * K * K);
+        int ic = (oc / OCG) * ICG + r / (K * K);
+        weight_flat[(oc * IC + ic) * K * K + r % (K * K)] = weight_grp[i];
+    }
+    for (int o = 0; o < OC; o++) {
+        bn_params[o*2]     = wt_int8 ? std::ldexp(1.0f + (WT8_SCALE_MANT ? (o % 3) * 0.3125f : 0.0f),
+                                              o % 4 - 3) : 1.0f;
+        bn_params[o*2 + 1] = (float)((o % 5) - 2) / 8.0f;
+    }
+    if (dw) pack_weights_dw(weight_grp, bn_params, weights_dram, IC, K, wt_int8);
+    else    pack_weights_tiled(weight_grp, bn_params, weights_dram, OC, ICG, K, wt_int8);
+
+    int stats[STAT_WORDS];
+    conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                nullptr, nullptr, nullptr,
+                IC, OC, H, W, K, S, P, P, P, P, use_pool, 2, 0, 0, 1, 0, wt_int8, 0,
+                -1, -1, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, G, stats,
+                nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+    conv_golden(input_flat, conv_out, weight_flat, bn_params,
+                IC, OC, H, W, K, S, P, P, OH, OW, 1);
+    if (use_pool) pool_golden(conv_out, golden, OC, OH, OW);
+    else          golden = conv_out;
+
+    int err_count = 0;
+    float max_err = 0.0f;
+    int total_elements = OC * FH * FW;
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_element(output_dram.data(), i);
+        float diff = std::abs((float)hw_val - (float)golden[i]);
+        if (diff > 0.05f) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d (oc=%d): HW=%f SW=%f diff=%f\n",
+                       i, i / (FH * FW), (float)hw_val, (float)golden[i], diff);
+            err_count++;
+        }
+        if (diff > max_err) max_err = diff;
+    }
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements, max_err=%.6f)\n", total_elements, max_err);
+        return 0;
+    } else {
+        printf("  FAILED! %d/%d errors, max_err=%.6f\n", err_count, total_elements, max_err);
+        return 1;
+    }
+}
+
+// Pruned layer through the channel remap tables (use_chan_map=1).
+// DRAM keeps ICP input / OCP output planes; the engine runs only the
+// active channels (every channel with c % 3 != 1) from compacted weights.
+// Golden = dense conv on the gathered input, scattered to the output
+// planes; pruned output planes must keep their sentinel value.
+int run_pruned_test(const char* name, int ICP, int OCP, int H, int W)
+{
+    const int K = 3;
+    std::vector<int> ic_map, oc_map;
+    for (int c = 0; c < ICP; c++) if (c % 3 != 1) ic_map.push_back(c);
+    for (int c = 0; c < OCP; c++) if (c % 3 != 1) oc_map.push_back(c);
+    int IC = ic_map.size(), OC = oc_map.size();
+
+    printf("\n===== Test: %s =====\n", name);
+    printf("  planes in/out %d/%d  active IC=%d OC=%d  %dx%d\n",
+           ICP, OCP, IC, OC, H, W);
+
+    std::vector<wide_t> input_dram((ICP * H * W) / 16 + 256, 0);
+    std::vector<wide_t> output_dram((OCP * H * W) / 16 + 256, 0);
+    std::vector<wide_t> weights_dram((OC + 15) / 16 * ((IC + 15) / 16) * (WT_HDR_BEATS + 16 * K * K) + 256, 0);
+    std::vector<data_t> bn_params(OC * 2, 0);
+
+    data_t sentinel = 7.5;
+    for (int i = 0; i < OCP * H * W; i++)
+        output_dram[i / 16].range((i % 16)*16+15, (i % 16)*16) = sentinel.range(15, 0);
+
+    // Plane-dependent pattern, so reading the wrong plane shows up
+    std::vector<data_t> input_flat(IC * H * W);
+    for (int i = 0; i < ICP * H * W; i++) {
+        data_t val = (float)((i + (i / (H * W)) * 37) % 100) / 100.0f;
+        input_dram[i / 16].range((i % 16)*16+15, (i % 16)*16) = val.range(15, 0);
+    }
+    for (int c = 0; c < IC; c++)
+        for (int p = 0; p < H * W; p++)
+            input_flat[c * H * W + p] = unpack_element(input_dram.data(), ic_map[c] * H * W + p);
+
+    std::vector<data_t> weight_flat(OC * IC * K * K);
+    for (int i = 0; i < OC * IC * K * K; i++)
+        weight_flat[i] = (float)((i % 7) - 3) / 10.0f;
+    for (int o = 0; o < OC; o++) {
+        bn_params[o*2]     = 1.0;
+        bn_params[o*2 + 1] = (float)((o % 5) - 2) / 8.0f;
+    }
+    pack_weights_tiled(weight_flat, bn_params, weights_dram, OC, IC, K, 0);
+
+    int stats[STAT_WORDS];
+    conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                ic_map.data(), oc_map.data(), nullptr,
+                IC, OC, H, W, K, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, -1, -1, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, stats,
+                nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+    std::vector<data_t> conv_out(OC * H * W);
+    conv_golden(input_flat, conv_out, weight_flat, bn_params,
+                IC, OC, H, W, K, 1, 1, 1, H, W, 1);
+
+    std::vector<data_t> golden(OCP * H * W, sentinel);
+    for (int o = 0; o < OC; o++)
+        for (int p = 0; p < H * W; p++)
+            golden[oc_map[o] * H * W + p] = conv_out[o * H * W + p];
+
+    int err_count = 0;
+    float max_err = 0.0f;
+    int total_elements = OCP * H * W;
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_element(output_dram.data(), i);
+        float diff = std::abs((float)hw_val - (float)golden[i]);
+        if (diff > 0.05f) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d (plane=%d): HW=%f SW=%f diff=%f\n",
+                       i, i / (H * W), (float)hw_val, (float)golden[i], diff);
+            err_count++;
+        }
+        if (diff > max_err) max_err = diff;
+    }
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements, max_err=%.6f)\n", total_elements, max_err);
+        return 0;
+    } else {
+        printf("  FAILED! %d/%d errors, max_err=%.6f\n", err_count, total_elements, max_err);
+        return 1;
+    }
+}
+
+// Activation statistics near the rails: OC o has all weights ±(o+1)/OC·1.5
+// (sign alternating), so the output range sweeps from a few units to past
+// ±128 and the upper channels saturate data_t — or, with out_shift ≥ 0,
+// the ACT8 range.  Checks the map and the STAT_* block (linear, 3x3/s1/p1).
+int run_stats_test(const char* name, int IC, int OC, int H, int W, int out_shift)
+{
+    const int K = 3;
+    printf("\n===== Test: %s =====\n", name);
+    printf("  IC=%d OC=%d %dx%d act8=%d\n", IC, OC, H, W, out_shift);
+
+    std::vector<wide_t> input_dram((IC * H * W) / 16 + 256, 0);
+    std::vector<wide_t> output_dram((OC * H * W) / 16 + 256, 0);
+    std::vector<wide_t> weights_dram((OC + 15) / 16 * ((IC + 15) / 16) * (WT_HDR_BEATS + 16 * K * K) + 256, 0);
+    std::vector<data_t> input_flat(IC * H * W);
+    std::vector<data_t> weight_flat(OC * IC * K * K);
+    std::vector<data_t> bn_params(OC * 2, 0);
+
+    for (int i = 0; i < IC * H * W; i++) {
+        input_flat[i] = (float)(i % 100) / 100.0f;
+        store_act(input_dram.data(), i, input_flat[i], -1);
+    }
+    for (int i = 0; i < OC * IC * K * K; i++) {
+        int o = i / (IC * K * K);
+        weight_flat[i] = ((o & 1) ? -1.5f : 1.5f) * (o + 1) / OC;
+    }
+    for (int o = 0; o < OC; o++) bn_params[o*2] = 1.0;
+    pack_weights_tiled(weight_flat, bn_params, weights_dram, OC, IC, K, 0);
+
+    std::vector<int> stats(STAT_WORDS, 0x5A5A5A5A);
+    conv_engine(input_dram.data(), output_dram.data(), weights_dram.data(),
+                nullptr, nullptr, nullptr,
+                IC, OC, H, W, K, 1, 1, 1, 1, 1, 0, 0, 0, 0, -1, 0, 0, 0, -1, out_shift, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, stats.data(),
+                nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+    std::vector<data_t> golden(OC * H * W);
+    conv_golden(input_flat, golden, weight_flat, bn_params,
+                IC, OC, H, W, K, 1, 1, 1, H, W, -1);
+
+    int err_count = 0;
+    int total_elements = OC * H * W;
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_act(output_dram.data(), i, out_shift);
+        data_t sw_val = (out_shift >= 0) ? act8_round(golden[i], out_shift) : golden[i];
+        if (hw_val != sw_val) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d: HW=%f SW=%f\n", i, (float)hw_val, (float)sw_val);
+            err_count++;
+        }
+    }
+    err_count += check_stats(stats.data(), golden, out_shift);
+    if (stats[STAT_SAT] == 0) {
+        printf("  No saturated values: test does not reach the rails\n");
+        err_count++;
+    }
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements)\n", total_elements);
+        return 0;
+    } else {
+        printf("  FAILED! %d errors\n", err_count);
+        return 1;
+    }
+}
+
+// Cross-invocation weight prefetch: layer A (IC → MID, 3x3, one HW×HW
+// tile) runs with layer B's weights as next_weights_dram, then B
+// (MID → OC, 3x3, wt_int8_b) runs on A's output with wt_staged=1.  The
+// blocks A prefetched are poisoned in B's DRAM copy, so B only matches
+// the golden chain if its first pass really streams them from the stage.
+// interpose=1 puts a rejected call (stride 3) between A and B and swaps
+// the copies: A stages the poisoned blocks, which B must now ignore.
+int run_prefetch_test(const char* name, int IC, int MID, int OC, int HW, int wt_int8_b,
+                      int interpose = 0)
+{
+    const int K = 3;
+    printf("\n===== Test: %s =====\n", name);
+    printf("  A: IC=%d OC=%d  B: IC=%d OC=%d w8=%d  %dx%d\n", IC, MID, MID, OC, wt_int8_b, HW, HW);
+
+    int ti_b = (MID + 15) / 16, to_b = (OC + 15) / 16;
+    int blk  = WT_HDR_BEATS + (wt_int8_b ? 8 : 16) * K * K;
+    int n_pf = std::min(to_b, WT_STAGE_WORDS / blk);
+
+    std::vector<wide_t> input_dram((IC * HW * HW) / 16 + 256, 0);
+    std::vector<wide_t> mid_dram((MID * HW * HW) / 16 + 256, 0);
+    std::vector<wide_t> output_dram((OC * HW * HW) / 16 + 256, 0);
+    std::vector<wide_t> wt_a((MID + 15) / 16 * ((IC + 15) / 16) * (WT_HDR_BEATS + 16 * K * K) + 256, 0);
+    std::vector<wide_t> wt_b(to_b * ti_b * blk + 256, 0);
+
+    std::vector<data_t> input_flat(IC * HW * HW), mid_flat(MID * HW * HW), golden(OC * HW * HW);
+    std::vector<data_t> w_a(MID * IC * K * K), w_b(OC * MID * K * K);
+    std::vector<data_t> bn_a(MID * 2), bn_b(OC * 2);
+    for (int i = 0; i < IC * HW * HW; i++) {
+        input_flat[i] = (float)(i % 100) / 100.0f;
+        store_act(input_dram.data(), i, input_flat[i], -1);
+    }
+    for (int i = 0; i < MID * IC * K * K; i++) w_a[i] = (float)((i % 7) - 3) / 10.0f;
+    for (int i = 0; i < OC * MID * K * K; i++)
+        w_b[i] = wt_int8_b ? (float)((i * 37) % 255 - 127) / 128.0f
+                           : (float)((i % 9) - 4) / 16.0f;
+    for (int o = 0; o < MID; o++) { bn_a[o*2] = 1.0; bn_a[o*2 + 1] = (float)((o % 5) - 2) / 8.0f; }
+    for (int o = 0; o < OC; o++)  { bn_b[o*2] = wt_int8_b ? 0.25 : 1.0; bn_b[o*2 + 1] = 0.5; }
+    pack_weights_tiled(w_a, bn_a, wt_a, MID, IC, K, 0);
+    pack_weights_tiled(w_b, bn_b, wt_b, OC, MID, K, wt_int8_b);
+
+    // B's weights with the blocks A stages poisoned
+    std::vector<wide_t> wt_b_bad = wt_b;
+    for (int q = 0; q < n_pf; q++)
+        for (int w = 0; w < blk; w++)
+            wt_b_bad[q * ti_b * blk + w] = ~wt_b[q * ti_b * blk + w];
+    std::vector<wide_t>& wt_b_next = interpose ? wt_b_bad : wt_b;
+    std::vector<wide_t>& wt_b_dram = interpose ? wt_b : wt_b_bad;
+
+    // Layer A, prefetching B's first blocks (IC tile 0 of each OC tile)
+    int stats[STAT_WORDS];
+    conv_engine(input_dram.data(), mid_dram.data(), wt_a.data(),
+                nullptr, nullptr, nullptr,
+                IC, MID, HW, HW, K, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0, -1, -1, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, stats,
+                wt_b_next.data(), to_b, blk, ti_b * blk, 0, 0, 0, nullptr, nullptr, nullptr);
+
+    // A call the engine rejects (stride 3) runs no layer, and drops the stage
+    if (interpose)
+        conv_engine(mid_dram.data(), output_dram.data(), wt_b.data(),
+                    nullptr, nullptr, nullptr,
+                    MID, OC, HW, HW, K, 3, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0, -1, -1, 0, 0, 0, 0,
+                    0, 0, 0, 0, 0, 0, stats,
+                    nullptr, 0, 0, 0, 0, 0, 0, nullptr, nullptr, nullptr);
+
+    // Layer B, wt_staged=1
+    conv_engine(mid_dram.data(), output_dram.data(), wt_b_dram.data(),
+                nullptr, nullptr, nullptr,
+                MID, OC, HW, HW, K, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, wt_int8_b, 0, -1, -1, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, stats,
+                nullptr, 0, 0, 0, 1, 0, 0, nullptr, nullptr, nullptr);
+
+    conv_golden(input_flat, mid_flat, w_a, bn_a, IC, MID, HW, HW, K, 1, 1, 1, HW, HW, 1);
+    conv_golden(mid_flat, golden, w_b, bn_b, MID, OC, HW, HW, K, 1, 1, 1, HW, HW, 1);
+    printf("  %d of %d B blocks staged (%d words each)\n", n_pf, to_b, blk);
+
+    int err_count = 0;
+    int total_elements = OC * HW * HW;
+    for (int i = 0; i < MID * HW * HW; i++)
+        if (unpack_element(mid_dram.data(), i) != mid_flat[i]) err_count++;
+    if (err_count) printf("  Layer A: %d errors\n", err_count);
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_element(output_dram.data(), i);
+        if (hw_val != golden[i]) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d (oc=%d): HW=%f SW=%f\n",
+                       i, i / (HW * HW), (float)hw_val, (float)golden[i]);
+            err_count++;
+        }
+    }
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements)\n", total_elements);
+        return 0;
+    } else {
+        printf("  FAILED! %d errors\n", err_count);
+        return 1;
+    }
+}
+
+// Job queue: an NL-layer 3x3 chain (channels alternating 16 / 24,
+// ping-ponging between two regions of one arena) described entirely by
+// descriptors.  The host keeps the JOBQ_DEPTH ring topped up as jobs
+// complete and re-invokes the engine (auto-restart) until jobs_done
+// reaches NL; each invocation runs at most `batch` jobs and stands for
+// one interrupt.  The session opens with a reset (job_tail < 0); a final
+// invocation with nothing queued must be a no-op that flags job_empty.
+int run_job_queue_test(const char* name, int NL, int HW, int batch)
+{
+    const int K = 3;
+    printf("\n===== Test: %s =====\n", name);
+    printf("  %d layers %dx%d, ring %d, batch %d\n", NL, HW, HW, JOBQ_DEPTH, batch);
+
+    const int act_words = 24 * HW * HW / 16 + 64;
+    const int wt_words  = 2 * 2 * (WT_HDR_BEATS + 16 * K * K);
+    std::vector<wide_t> act((2 * act_words) + 256, 0);
+    std::vector<wide_t> wts(NL * wt_words + 256, 0);
+    std::vector<int>    stats(NL * STAT_WORDS, 0x5A5A5A5A);
+
+    std::vector<int> ch(NL + 1);
+    for (int l = 0; l <= NL; l++) ch[l] = (l % 2) ? 24 : 16;
+
+    std::vector<data_t> cur(ch[0] * HW * HW), nxt;
+    for (int i = 0; i < ch[0] * HW * HW; i++) {
+        cur[i] = (float)((i * 13) % 64 - 32) / 64.0f;
+        store_act(act.data(), i, cur[i], -1);
+    }
+
+    // Weights for every layer, and the golden chain alongside
+    for (int l = 0; l < NL; l++) {
+        int IC = ch[l], OC = ch[l + 1];
+        std::vector<data_t> w(OC * IC * K * K), bn(OC * 2);
+        for (int i = 0; i < OC * IC * K * K; i++) w[i] = (float)((i + l) % 7 - 3) / 32.0f;
+        for (int o = 0; o < OC; o++) { bn[o*2] = 1.0; bn[o*2 + 1] = (float)((o + l) % 5 - 2) / 8.0f; }
+        std::vector<wide_t> packed(wt_words + 256, 0);
+        pack_weights_tiled(w, bn, packed, OC, IC, K, 0);
+        std::copy(packed.begin(), packed.begin() + wt_words, wts.begin() + l * wt_words);
+        nxt.assign(OC * HW * HW, 0);
+        conv_golden(cur, nxt, w, bn, IC, OC, HW, HW, K, 1, 1, 1, HW, HW, 1);
+        cur.swap(nxt);
+    }
+
+    // New session: job_tail < 0 resets the engine's head
+    int q[JOBQ_DEPTH * JOB_WORDS];
+    int queued = 0, done = -1, empty = -1, irqs = 0, err_count = 0;
+    conv_engine(act.data(), act.data(), wts.data(),
+                nullptr, nullptr, nullptr,
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, stats.data(),
+                nullptr, 0, 0, 0, 0, -1, batch, q, &done, &empty);
+    if (done != 0) {
+        printf("  Reset: jobs_done=%d, expected 0\n", done);
+        err_count++;
+    }
+    while (done < NL) {
+        // Host ISR: refill every slot below jobs_done
+        for (; queued < NL && queued - done < JOBQ_DEPTH; queued++) {
+            int* d = q + (queued % JOBQ_DEPTH) * JOB_WORDS;
+            for (int k = 0; k < JOB_WORDS; k++) d[k] = 0;
+            d[JOB_IN_OFF]      = (queued % 2) * act_words;
+            d[JOB_OUT_OFF]     = ((queued + 1) % 2) * act_words;
+            d[JOB_WT_OFF]      = queued * wt_words;
+            d[JOB_STATS_OFF]   = queued * STAT_WORDS;
+            d[JOB_IN_CHANNELS] = ch[queued];
+            d[JOB_OUT_CHANNELS] = ch[queued + 1];
+            d[JOB_IN_HEIGHT]   = HW;
+            d[JOB_IN_WIDTH]    = HW;
+            d[JOB_KERNEL_SIZE] = K;
+            d[JOB_STRIDE]      = 1;
+            d[JOB_PAD_TOP]  = d[JOB_PAD_BOTTOM] = d[JOB_PAD_LEFT] = d[JOB_PAD_RIGHT] = 1;
+            d[JOB_USE_LEAKY]   = 1;
+            d[JOB_IN_ACT_SHIFT] = d[JOB_OUT_ACT_SHIFT] = -1;
+        }
+        int before = done;
+        conv_engine(act.data(), act.data(), wts.data(),
+                    nullptr, nullptr, nullptr,
+                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                    0, 0, 0, 0, 0, 0, stats.data(),
+                    nullptr, 0, 0, 0, 0, queued, batch, q, &done, &empty);
+        irqs++;
+        if (done != std::min(before + batch, queued) || empty != 0) {
+            printf("  Invocation %d: jobs_done=%d job_empty=%d, expected %d 0\n",
+                   irqs, done, empty, std::min(before + batch, queued));
+            err_count++;
+            break;
+        }
+    }
+    int expect_irqs = (NL + batch - 1) / batch;
+    if (irqs != expect_irqs) {
+        printf("  %d invocations (interrupts), expected %d\n", irqs, expect_irqs);
+        err_count++;
+    }
+
+    // Auto-restart with an empty queue: no job runs, output untouched,
+    // and job_empty tells the host this ap_done is not a completion
+    int out_base = (NL % 2) * act_words;
+    std::vector<wide_t> snap(act.begin(), act.end());
+    conv_engine(act.data(), act.data(), wts.data(),
+                nullptr, nullptr, nullptr,
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, stats.data(),
+                nullptr, 0, 0, 0, 0, queued, batch, q, &done, &empty);
+    if (done != NL || empty != 1 || !std::equal(act.begin(), act.end(), snap.begin())) {
+        printf("  Idle invocation ran a job (jobs_done=%d job_empty=%d)\n", done, empty);
+        err_count++;
+    }
+    for (int l = 0; l < NL; l++)
+        if (stats[l * STAT_WORDS + STAT_COUNT] != ch[l + 1] * HW * HW) {
+            printf("  Layer %d: stats block not written\n", l);
+            err_count++;
+        }
+
+    int total_elements = ch[NL] * HW * HW;
+    for (int i = 0; i < total_elements; i++) {
+        data_t hw_val = unpack_element(act.data() + out_base, i);
+        if (hw_val != cur[i]) {
+            if (err_count < 10)
+                printf("  Error @ flat=%d (oc=%d): HW=%f SW=%f\n",
+                       i, i / (HW * HW), (float)hw_val, (float)cur[i]);
+            err_count++;
+        }
+    }
+    printf("  %d jobs in %d invocations\n", done, irqs);
+
+    if (err_count == 0) {
+        printf("  PASSED! (%d elements)\n", total_elements);
+        return 0;
+    } else {
+        printf("  FAILED! %d errors\n", err_count);
+        return 1;
+    }
+}
+
 int main() {
     std::cout << "Starting Conv Engine Testbench..." << std::endl;
     int failures = 0;
@@ -236,6 +1177,211 @@ int main() {
     failures += run_test("LeakyReLU 16x16 IC=3 OC=16",
                          3, 16, 16, 16, 3, 1, 1, 0, 0, 1);
 
+    // Test 7: Row-strip mode across several strips and column tiles
+    //   IC=16 (one IC tile), W=52 → 4 column tiles served from one strip,
+    //   H=40 → 3 strips, so the K-1 halo rows are carried twice.
+    failures += run_test("Row-strip 40x52 IC=16 OC=16 pooled",
+                         16, 16, 40, 52, 3, 1, 1, 1, 2, 1);
+    //   IC=3 as on conv1: lanes 3..15 are cleared by the first strip only.
+    failures += run_test("Row-strip 40x52 IC=3 OC=16",
+                         3, 16, 40, 52, 3, 1, 1, 0, 0, 1);
+
+    // Test 8: Multi IC tile (tiled fetch path + psum accumulation)
+    //   IC=40 → 3 IC tiles, so strip mode is disabled.
+    failures += run_test("Multi-IC 20x20 IC=40 OC=40",
+                         40, 40, 20, 20, 3, 1, 1, 0, 0, 1);
+
+    // Test 9: Column-halo reuse on the tiled path
+    //   IC=20 → 2 IC tiles (no strip), W=40 → 3 column tiles, so each
+    //   IC tile's right-edge columns are carried twice.
+    failures += run_test("Column-halo 24x40 IC=20 OC=16 pooled",
+                         20, 16, 24, 40, 3, 1, 1, 1, 2, 1);
+
+    // Test 10: Fused conv1->conv3 row-streaming mode
+    //   48x56 image → 24x28 → 12x14 → 6x7; the two intermediates stay
+    //   on chip.  Non-square, and 6x7 output rows are not word aligned.
+    failures += run_fused_test("Fused conv1-conv3 48x56", 48, 56);
+
+    // Test 11: conv6-style ZeroPad2d(0,1,0,1) + 2x2 stride-1 pool in HW
+    //   13x13 → 13x13, single tile; the padded bottom row/right col
+    //   pool against zeros.
+    failures += run_test_pad("Pool s1 pad(0,1,0,1) 13x13 IC=20 OC=16",
+                             20, 16, 13, 13, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1);
+
+    // Test 12: stride-1 pool across overlapped tiles (step 15)
+    //   OH=OW=34 → 3x3 tile grid; pooled 33x33 (no pool pad), so tile
+    //   edges use the neighbour's overlapping row/column.
+    failures += run_test_pad("Pool s1 multi-tile 34x34 IC=3 OC=16",
+                             3, 16, 34, 34, 3, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1);
+
+    // Test 13: asymmetric conv padding + ceil-mode stride-2 pool
+    //   "same" 2x2 kernel: pad (0,1,0,1); OH=OW=27 odd, pool pad (1,1)
+    //   → 14x14 with a zero-padded last window.
+    failures += run_test_pad("Asym pad K=2 27x27 pooled ceil",
+                             16, 16, 27, 27, 2, 1, 0, 1, 0, 1, 1, 2, 1, 1, 1);
+
+    // Test 14: stride-2 conv with top/left-only padding (TF "same")
+    //   H=W=33, K=3, S=2, pad (1,0,1,0) → 16x16, plus 2 column tiles
+    //   on the wider map.
+    failures += run_test_pad("Stride-2 pad(1,0,1,0) 33x41 IC=16 OC=16",
+                             16, 16, 33, 41, 3, 2, 1, 0, 1, 0, 0, 0, 0, 0, 1);
+
+    // Test 15: pruned layer via channel remap tables
+    //   48 → 32 active input planes (2 full IC tiles, tiled path) and
+    //   40 → 27 active output planes at a 2x2 tile grid; the 13 pruned
+    //   output planes are never written.
+    failures += run_pruned_test("Chan-map pruned 20x20 IC=48 OC=40", 48, 40, 20, 20);
+
+    // Test 16: W8A16 — int8 weights, 16-bit activations
+    //   IC=40 → 3 IC tiles (last one partial), so the 360-byte OC blocks
+    //   start mid-word; 13x13 like the weight-bound tail layers.
+    failures += run_test_pad("W8A16 13x13 IC=40 OC=40",
+                             40, 40, 13, 13, 3, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1);
+
+    // Test 17: ACT8 maps on the tiled path (column-halo, 2 IC tiles)
+    //   int8 input at shift 1 and int8 pooled output at shift 4; 40-wide
+    //   rows and 20-wide pooled rows straddle 32-element words.
+    failures += run_test_pad("ACT8 in/out 24x40 IC=20 OC=16 pooled",
+                             20, 16, 24, 40, 3, 1, 1, 1, 1, 1, 1, 2, 0, 0, 1, 0, 1, 4);
+
+    // Test 18: ACT8 through the row-strip fetch and the direct write path
+    //   52-wide rows: each strip burst starts mid-word.
+    failures += run_test_pad("ACT8 row-strip 40x52 IC=16 OC=16",
+                             16, 16, 40, 52, 3, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 2, 3);
+
+    // Test 19: plane-burst fetch on a stride-2 single-tile layer
+    //   15x15 → 8x8, IC=20 (2 IC tiles, tiled path) with an ACT8 input:
+    //   each 225-element plane is one burst of 8 words starting mid-word.
+    failures += run_test_pad("Plane burst s2 15x15 IC=20 OC=16 act8 in",
+                             20, 16, 15, 15, 3, 2, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 1, -1);
+
+    // Test 20: flattened compute pass on tiny edge tiles
+    //   17x17 → 16+1 tiles: a 1x1 corner tile (bubble-padded sweep) and
+    //   1-row edge tiles whose psum load/save walk a single row.
+    failures += run_test("Tiny edge tiles 17x17 IC=20 OC=16",
+                         20, 16, 17, 17, 3, 1, 1, 0, 0, 1);
+
+    // Test 21: one-row-per-cycle pack with RMW edges on every row
+    //   Stride-1 pool with pool pad (1,1) → 34x34 ACT8 output: 15-wide
+    //   blocks land at arbitrary slots of 32-element words, and OC=20
+    //   leaves a 4-plane second OC tile.
+    failures += run_test_pad("Pool s1 ACT8 out 34x34 IC=3 OC=20",
+                             3, 20, 34, 34, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, -1, 4);
+
+    // Test 22: 2x nearest upsample on write (Tiny-YOLOv3 route)
+    //   1x1 conv 13x13 → 26x26 planes; every tile row becomes two 26-wide
+    //   rows of up to three words, OC=20 leaves a partial OC tile.
+    failures += run_test_pad("Upsample 1x1 13x13 IC=20 OC=20",
+                             20, 20, 13, 13, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+                             0, -1, -1, 1, 0);
+
+    // Test 23: residual add fused with pool, upsample and ACT8 output
+    //   24x40 → pooled 12x20 → upsampled 24x40 + residual, int8 at shift 4.
+    failures += run_test_pad("Upsample+add ACT8 24x40 IC=20 OC=16 pooled",
+                             20, 16, 24, 40, 3, 1, 1, 1, 1, 1, 1, 2, 0, 0, 1,
+                             0, -1, 4, 1, 1);
+
+    // Test 24: residual add alone, 16-bit, multi-tile with 2 OC tiles
+    failures += run_test_pad("Residual add 20x20 IC=40 OC=40",
+                             40, 40, 20, 20, 3, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+                             0, -1, -1, 0, 1);
+
+    // Test 25: zero-copy concat via oc_offset / total_out_channels
+    //   13x13 planes (169 elements) so the seam between the two layers'
+    //   slices falls mid-word; a trailing plane stays untouched.
+    failures += run_concat_test("Concat 20+24 planes 13x13 IC=20", 20, 20, 24, 13, 13);
+
+    // Test 26: strided input views (crop + channel slice, read in place)
+    //   a) row strips: a 30x45 window at (3,5) of a 40x64 frame, planes
+    //      7..26 of 40 — every row burst starts mid-word.
+    //   b) tiled path, ACT8 frame, 2x2 tiles with column halo.
+    //   c) single tile with a narrow crop: the pitch forces row bursts
+    //      instead of plane bursts.
+    //   d) full-width band (row_pitch == in_width): plane bursts from
+    //      a nonzero origin and a plane pitch > H·W.
+    //   e) fused conv1-conv3 on a 64x64 crop of a 72x72 frame.
+    failures += run_view_test("View 30x45 @(3,5) of 40x40x64, planes 7..26",
+                              20, 16, 30, 45, 40, 40, 64, 7, 3, 5);
+    failures += run_view_test("View ACT8 34x34 @(1,2) of 24x40x40, planes 4..23",
+                              20, 16, 34, 34, 24, 40, 40, 4, 1, 2, 3);
+    failures += run_view_test("View 13x13 @(2,1) of 24x16x16, planes 3..22",
+                              20, 16, 13, 13, 24, 16, 16, 3, 2, 1);
+    failures += run_view_test("View rows 2..14 of 24x18x13, planes 3..22",
+                              20, 16, 13, 13, 24, 18, 13, 3, 2, 0);
+    failures += run_fused_test("Fused 64x64 crop of 72x72", 64, 64, 4);
+
+    // Test 27: grouped and depthwise convolution
+    //   a) depthwise 3x3/s1, 40 channels (partial third tile), 3x3 tile grid
+    //   b) depthwise 3x3/s2 + pool, int8 weights: odd 9-beat block, and
+    //      window rows/cols that start in every bank
+    //   c) depthwise on the row-strip fetch (16 channels, 52 wide)
+    //   d) 2 groups of 32 → 16: two IC tiles per group through psum_buf
+    failures += run_grouped_test("Depthwise 34x34 C=40",
+                                 40, 40, 40, 34, 34, 3, 1, 0);
+    failures += run_grouped_test("Depthwise s2 pooled W8 35x37 C=32",
+                                 32, 32, 32, 35, 37, 3, 2, 1, 1);
+    failures += run_grouped_test("Depthwise row-strip 24x52 C=16",
+                                 16, 16, 16, 24, 52, 3, 1, 0);
+    failures += run_grouped_test("Groups=2 20x20 IC=64 OC=32",
+                                 64, 32, 2, 20, 20, 3, 1, 0);
+
+    // Test 28: activation statistics (every run_test_pad call also checks
+    // the STAT_* block against its golden map; these reach the clip paths)
+    //   a) ACT8 output at shift 1 (±0.25): most values clip, and some
+    //      only after rounding up to 128
+    //   b) sums past both data_t rails, 16-bit output (2 OC tiles)
+    //   c) the same map as ACT8 at shift 4 (±8): most channels clip
+    failures += run_test_pad("Stats ACT8 clip 20x20 IC=40 OC=40",
+                             40, 40, 20, 20, 3, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+                             0, -1, 1);
+    failures += run_stats_test("Stats data_t rails 18x21 IC=32 OC=24",
+                               32, 24, 18, 21, -1);
+    failures += run_stats_test("Stats ACT8 rails 18x21 IC=32 OC=24",
+                               32, 24, 18, 21, 4);
+
+    // Test 29: cross-invocation weight prefetch (13x13, one tile)
+    //   a) dense B: all 3 OC tiles' first blocks staged
+    //   b) W8A16 B, 8 OC tiles of 74-word blocks: all staged
+    //   c) 10 OC tiles of 146 words: 7 fit, the rest come from DRAM
+    failures += run_prefetch_test("Prefetch 13x13 20->32->40", 20, 32, 40, 13, 0);
+    failures += run_prefetch_test("Prefetch W8 13x13 16->48->128", 16, 48, 128, 13, 1);
+    failures += run_prefetch_test("Prefetch overflow 13x13 16->24->160", 16, 24, 160, 13, 0);
+    //   d) a rejected call between A and B: B ignores the stale stage
+    failures += run_prefetch_test("Prefetch dropped 13x13 20->32->40", 20, 32, 40, 13, 0, 1);
+
+    // Test 30: job queue — 20 descriptor-driven layers through the 16-slot
+    //   ring, refilled between invocations; 4 (and 7) jobs per interrupt
+    failures += run_job_queue_test("Job queue 20 layers 8x8 batch 4", 20, 8, 4);
+    failures += run_job_queue_test("Job queue 20 layers 8x8 batch 7", 20, 8, 7);
+
+    // Test 31: stride-2 conv as the pooling replacement — Tiny-YOLO
+    //   conv1–conv5 shapes (3x3, pad 1: H → H/2, window streaming and the
+    //   K - stride column halo; conv2 takes the row-strip fetch), then the
+    //   corner cases (the IC=16 ones below are row strips too)
+    //   a) conv1..conv5: 3->16 @416 … 128->256 @26
+    const int ty_ch[6] = { 3, 16, 32, 64, 128, 256 };
+    for (int l = 0; l < 5; l++) {
+        char name[64];
+        snprintf(name, sizeof(name), "Stride-2 conv%d %dx%d IC=%d OC=%d",
+                 l + 1, 416 >> l, 416 >> l, ty_ch[l], ty_ch[l + 1]);
+        failures += run_test_pad(name, ty_ch[l], ty_ch[l + 1], 416 >> l, 416 >> l,
+                                 3, 2, 1, 1, 1, 1, 0, 0, 0, 0, 1);
+    }
+    //   b) TF "same" pad (0,1,0,1), even map, ACT8 in and out
+    failures += run_test_pad("Stride-2 same-pad ACT8 52x52 IC=32 OC=64",
+                             32, 64, 52, 52, 3, 2, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 3, 2);
+    //   c) odd map: partial last tiles, halo across 3 column tiles, W8
+    failures += run_test_pad("Stride-2 odd W8 67x93 IC=48 OC=40",
+                             48, 40, 67, 93, 3, 2, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1);
+    //   d) 1x1 and 2x2 stride-2 (no shared columns), linear
+    failures += run_test_pad("Stride-2 K=1 41x70 IC=24 OC=16",
+                             24, 16, 41, 70, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0, -1);
+    failures += run_test_pad("Stride-2 K=2 66x66 IC=16 OC=32",
+                             16, 32, 66, 66, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 1);
+    //   e) stride 2 followed by the epilogue 2x2/2 pool
+    failures += run_test_pad("Stride-2 + pool 70x70 IC=16 OC=16",
+                             16, 16, 70, 70, 3, 2, 1, 1, 1, 1, 1, 2, 0, 0, 1);
+
     printf("\n===== SUMMARY =====\n");
     if (failures == 0) {
         printf("All tests PASSED!\n");
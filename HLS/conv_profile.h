@@ -0,0 +1,141 @@
+/**
+ * conv_profile.h — C-sim FIFO occupancy instrumentation
+ *
+ * Only included when building with -DCONV_PROFILE (never synthesized).
+ *
+ * === Timing model ===
+ * C-sim runs the DATAFLOW processes one after another (Fetch, then
+ * Execute, then Write), so raw stream sizes say nothing about real FIFO
+ * occupancy.  Instead every process keeps a virtual cycle counter:
+ *  - each stream read/write costs one cycle (all stream loops are II=1),
+ *  - non-stream loop nests charge their trip count via PROF_CYCLES(),
+ *  - each AXI read burst additionally pays PROF_AXI_LATENCY cycles,
+ *  - each start of the MAC pipeline pays PROF_MAC_DEPTH fill cycles,
+ *  - a read of beat k cannot complete before cycle write_time[k] + 1
+ *    (the consumer stalls — a "blocked read").
+ *
+ * Write and read timestamps of every beat are committed per stream when
+ * the stream is destroyed at the end of conv_dataflow.  The profiling
+ * driver (conv_engine_profile.cpp) turns them into high-water marks,
+ * blocked-write estimates and a recommended minimum depth.
+ *
+ * Verilog analogy: a testbench monitor on each FIFO's wr_en / rd_en.
+ */
+#ifndef CONV_PROFILE_H
+#define CONV_PROFILE_H
+
+#include <hls_stream.h>
+#include <string>
+#include <vector>
+
+/* Approximate DDR4 read latency seen by an HP port, in PL cycles */
+#ifndef PROF_AXI_LATENCY
+#define PROF_AXI_LATENCY 40
+#endif
+
+/* Fill/drain depth of the 256-MAC pipeline (multiply + 16-input adder tree
+ * + accumulate), paid every time the COMPUTE loop is (re)entered; the
+ * MAC_CASCADE chain adds one register per IC lane */
+#ifndef PROF_MAC_DEPTH
+#if MAC_CASCADE
+#define PROF_MAC_DEPTH 28
+#else
+#define PROF_MAC_DEPTH 12
+#endif
+#endif
+
+typedef unsigned long long prof_cycle_t;
+
+/* ---- Per-stream record committed at the end of a layer ---- */
+struct prof_stream_rec {
+    std::string name;
+    std::vector<prof_cycle_t> t_wr;    /* producer cycle of beat k       */
+    std::vector<prof_cycle_t> t_rd;    /* consumer cycle of beat k       */
+    unsigned long long blk_rd;         /* reads that stalled on empty    */
+    prof_cycle_t       blk_rd_cycles;  /* total cycles lost to those     */
+};
+
+/* ---- Per-process record (virtual latency of one DATAFLOW stage) ---- */
+struct prof_stage_rec {
+    std::string  name;
+    prof_cycle_t cycles;
+};
+
+/* ---- Global profiler state (inline functions with function-local statics,
+ * shared across translation units) ---- */
+inline prof_cycle_t& prof_clock() {
+    static prof_cycle_t clk = 0;
+    return clk;
+}
+inline std::vector<prof_stream_rec>& prof_streams() {
+    static std::vector<prof_stream_rec> recs;
+    return recs;
+}
+inline std::vector<prof_stage_rec>& prof_stages() {
+    static std::vector<prof_stage_rec> recs;
+    return recs;
+}
+
+/* Called by the driver before each conv_engine() invocation */
+inline void prof_reset() {
+    prof_clock() = 0;
+    prof_streams().clear();
+    prof_stages().clear();
+}
+
+/* RAII guard: one per DATAFLOW process, restarts the virtual clock */
+struct prof_stage_guard {
+    std::string name;
+    explicit prof_stage_guard(const char* n) : name(n) { prof_clock() = 0; }
+    ~prof_stage_guard() {
+        prof_stage_rec rec;
+        rec.name   = name;
+        rec.cycles = prof_clock();
+        prof_stages().push_back(rec);
+    }
+};
+
+#define PROF_STAGE(n)   prof_stage_guard prof_stage_(n)
+#define PROF_CYCLES(n)  (prof_clock() += (prof_cycle_t)(n))
+
+/* =========================================================================
+ * Instrumented FIFO — drop-in for hls::stream<T> in conv_dataflow
+ * ========================================================================= */
+template <typename T>
+class prof_stream {
+public:
+    explicit prof_stream(const char* n) : fifo_(n) {
+        rec_.name          = n;
+        rec_.blk_rd        = 0;
+        rec_.blk_rd_cycles = 0;
+    }
+
+    ~prof_stream() { prof_streams().push_back(rec_); }
+
+    void write(const T& v) {
+        rec_.t_wr.push_back(prof_clock());
+        prof_clock() += 1;
+        fifo_.write(v);
+    }
+
+    T read() {
+        size_t k = rec_.t_rd.size();
+        prof_cycle_t ready = (k < rec_.t_wr.size()) ? rec_.t_wr[k] + 1 : 0;
+        if (prof_clock() < ready) {
+            rec_.blk_rd++;
+            rec_.blk_rd_cycles += ready - prof_clock();
+            prof_clock() = ready;
+        }
+        rec_.t_rd.push_back(prof_clock());
+        prof_clock() += 1;
+        return fifo_.read();
+    }
+
+    bool empty() { return fifo_.empty(); }
+
+private:
+    hls::stream<T>  fifo_;
+    prof_stream_rec rec_;
+};
+
+#endif /* CONV_PROFILE_H */
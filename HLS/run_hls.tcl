@@ -10,7 +10,14 @@ set top_func     "conv_engine"
 # ZCU102 Part Number (Zynq UltraScale+ XCZU9EG)
 set target_part  "xczu9eg-ffvb1156-2-e" 
 
-set clock_period 7
+# MAC datapath: 0 = saturating adder tree, 1 = DSP48E2 cascade
+# (conv_engine.h, MAC_CASCADE), which is meant to close at 4 ns
+set mac_cascade  0
+set clock_period [expr {$mac_cascade ? 4 : 7}]
+# W8A16 dequant scale: 0 = power of two (shift-only epilogue), 1 = adds the
+# 11-bit mantissa multiply per OC lane (conv_engine.h, WT8_SCALE_MANT)
+set wt8_scale_mant 0
+set cflags "-DMAC_CASCADE=$mac_cascade -DCLK_PERIOD_NS=$clock_period -DWT8_SCALE_MANT=$wt8_scale_mant"
 
 # 2. Create Project
 # -----------------
@@ -18,11 +25,11 @@ open_project -reset $project_name
 
 # 3. Add Source Files
 # -------------------
-add_files conv_engine.cpp
+add_files conv_engine.cpp -cflags $cflags
 add_files conv_engine.h
 
 # Add Testbench (Essential for verification)
-add_files -tb conv_engine_tb.cpp
+add_files -tb conv_engine_tb.cpp -cflags $cflags
 
 # 4. Set Top Level
 # ----------------
@@ -46,6 +53,28 @@ config_interface -m_axi_addr64=1
 puts "### Running Synthesis for ZCU102 ###"
 csynth_design
 
+# 7b. ACC_RAW_DIST check
+# ----------------------
+# COMPUTE_P declares a true acc_buf dependence at distance ACC_RAW_DIST,
+# since a pixel is revisited no sooner than that (conv_engine.h).  If the
+# acc_buf load→store span is longer, HLS raises the II rather than break
+# the hazard.  Log the loop's achieved II and the clock estimate: an II
+# above 1 means ACC_RAW_DIST is smaller than the synthesized latency.
+set rpt_dir "$project_name/solution1/syn/report"
+set log [open "acc_raw_check.log" w]
+puts $log "MAC_CASCADE=$mac_cascade  clock=${clock_period} ns"
+foreach f [glob -nocomplain $rpt_dir/*.rpt] {
+    set fh [open $f r]
+    foreach line [split [read $fh] "\n"] {
+        if {[string match "*COMPUTE_P*" $line] || [string match "*ap_clk*" $line]} {
+            puts $log "[file tail $f]: $line"
+        }
+    }
+    close $fh
+}
+close $log
+puts "### COMPUTE_P II and timing estimate written to acc_raw_check.log ###"
+
 # 8. Export IP (Creates the ZIP file)
 # -----------------------------------
 puts "### Exporting IP to ZIP ###"
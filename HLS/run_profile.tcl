@@ -0,0 +1,37 @@
+# ==============================================================================
+# TinyYOLO Convolution Engine - FIFO Occupancy Profiling (C-sim only)
+# ==============================================================================
+# Runs the full Tiny-YOLO layer table through an instrumented C-sim build
+# (-DCONV_PROFILE) and prints per-layer stream high-water marks, blocked
+# read/write counts and recommended INPUT/WEIGHT/OUTPUT_STREAM_DEPTH.
+#
+# Usage:  vitis-run --mode hls --tcl run_profile.tcl
+
+# 1. Project Settings
+# -------------------
+set project_name "tinyyolo_zcu102_profile"
+set top_func     "conv_engine"
+set target_part  "xczu9eg-ffvb1156-2-e"
+
+# 2. Create Project
+# -----------------
+open_project -reset $project_name
+
+# 3. Add Source Files (instrumented)
+# ----------------------------------
+add_files conv_engine.cpp -cflags "-DCONV_PROFILE"
+add_files conv_engine.h
+add_files conv_profile.h
+add_files -tb conv_engine_profile.cpp -cflags "-DCONV_PROFILE"
+
+set_top $top_func
+
+open_solution -reset "solution1"
+set_part $target_part
+
+# 4. Run C-sim (no synthesis — profile build is not synthesizable)
+# ----------------------------------------------------------------
+puts "### Running FIFO occupancy profile ###"
+csim_design
+
+exit